@@ -27,9 +27,11 @@
 #ifndef INCLUDE_SST_BASIC_BLOCKS_DSP_DPWSAWPULSEOSCILLATOR_H
 #define INCLUDE_SST_BASIC_BLOCKS_DSP_DPWSAWPULSEOSCILLATOR_H
 
+#include <algorithm>
 #include <cstdint>
 #include <cmath>
 
+#include "sst/basic-blocks/simd/setup.h"
 #include "SmoothingStrategies.h"
 
 namespace sst::basic_blocks::dsp
@@ -42,6 +44,13 @@ namespace sst::basic_blocks::dsp
  * Evaluate it at 3 points and then differentiate it like
  * we do in Surge Modern. The waveform is the same both
  * channels.
+ *
+ * Away from the wrap the second difference of that cubic is exactly
+ * the naive saw 2p-1, and across the wrap it only picks up a square
+ * term from whichever neighbour wrapped, so we evaluate that closed
+ * form rather than differencing three cubics. It is the same curve,
+ * but has no cancellation so it also works in float (see
+ * DPWOscillatorBank below).
  */
 template <typename SmoothingStrategy = LagSmoothingStrategy> struct DPWSawOscillator
 {
@@ -57,22 +66,9 @@ template <typename SmoothingStrategy = LagSmoothingStrategy> struct DPWSawOscill
 
     inline static double valueAt(double p, double dp)
     {
-        double res = p * 2 - 1;
-        if (p < 3 * dp || p > (1 - 3 * dp))
-        {
-            double phaseSteps[3];
-            for (int q = -1; q <= 1; ++q)
-            {
-                double ph = p - q * dp;
-                ph = ph - std::floor(ph);
-                ph = ph * 2 - 1;
-                phaseSteps[q + 1] = (ph * ph - 1) * ph / 6.0;
-            }
-
-            res = (phaseSteps[0] + phaseSteps[2] - 2 * phaseSteps[1]) / (4 * dp * dp);
-        }
-
-        return res;
+        auto over = std::max(p + dp - 1, 0.0) / dp;
+        auto under = std::max(dp - p, 0.0) / dp;
+        return p * 2 - 1 - over * over + under * under;
     }
     inline double step()
     {
@@ -139,6 +135,179 @@ template <typename SmoothingStrategy = LagSmoothingStrategy> struct DPWPulseOsci
     typename SmoothingStrategy::smoothValue_t dPhase;
     typename SmoothingStrategy::smoothValue_t pulseWidth;
 };
+
+/*
+ * nLanes (a multiple of 4) independent DPW saws or pulses, four to a SIMD register, for
+ * unison stacks and cheap polyphony. Phase is 32 bit fixed point, so it wraps for free
+ * and keeps exact pitch at low frequencies where a float phase would drift, and the pulse
+ * is the saw minus the saw at phase plus width, which also just wraps. The saw is the
+ * closed form in DPWSawOscillator::valueAt in float, so the whole step is branchless.
+ * Frequency and width move linearly to their targets over each block.
+ */
+template <int nLanes, bool isPulse = false> struct DPWOscillatorBank
+{
+    static_assert(nLanes > 0 && nLanes % 4 == 0, "DPWOscillatorBank lanes come in fours");
+    static constexpr int nQuads{nLanes / 4};
+
+    DPWOscillatorBank()
+    {
+        for (int i = 0; i < nLanes; ++i)
+            pulseWidthTarget[i] = 0.5f;
+        retrigger();
+    }
+
+    void retrigger()
+    {
+        for (int q = 0; q < nQuads; ++q)
+            phase[q] = SIMD_MM(setzero_si128)();
+        snapToTargets = true;
+    }
+
+    void setFrequency(int lane, double freqInHz, double sampleRateInv)
+    {
+        dPhaseTarget[lane] = (float)std::clamp(freqInHz * sampleRateInv, 1e-7, 0.49);
+    }
+
+    /*
+     * Spread the lanes evenly over +/- detuneInSemitones around freqInHz, as for a
+     * supersaw. A single lane sits at freqInHz.
+     */
+    void setUnisonFrequencies(double freqInHz, double detuneInSemitones, double sampleRateInv)
+    {
+        for (int i = 0; i < nLanes; ++i)
+        {
+            auto spread = nLanes == 1 ? 0.0 : (2.0 * i / (nLanes - 1) - 1.0);
+            setFrequency(i, freqInHz * std::pow(2.0, spread * detuneInSemitones / 12.0),
+                         sampleRateInv);
+        }
+    }
+
+    void setPulseWidth(int lane, float pw) { pulseWidthTarget[lane] = std::clamp(pw, 0.f, 1.f); }
+
+    /*
+     * Set the phase of a lane in [0,1), for instance to decorrelate unison voices.
+     */
+    void setPhase(int lane, float ph)
+    {
+        alignas(16) uint32_t p[4];
+        SIMD_MM(store_si128)((SIMD_M128I *)p, phase[lane / 4]);
+        p[lane % 4] = toFixed(ph - std::floor(ph));
+        phase[lane / 4] = SIMD_MM(load_si128)((const SIMD_M128I *)p);
+    }
+
+    /*
+     * Render blockSize samples for each lane; out[lane] is a block of blockSize samples.
+     */
+    template <int blockSize> void fillBlock(float *const *out)
+    {
+        alignas(16) float res[4];
+        forBlock<blockSize>([&](int q, int s, SIMD_M128 v) {
+            SIMD_MM(store_ps)(res, v);
+            for (int i = 0; i < 4; ++i)
+                out[q * 4 + i][s] = res[i];
+        });
+    }
+
+    /*
+     * Render blockSize samples of all the lanes summed, as for a unison stack.
+     */
+    template <int blockSize> void fillBlockSummed(float *out)
+    {
+        SIMD_M128 acc;
+        forBlock<blockSize>([&](int q, int s, SIMD_M128 v) {
+            acc = (q == 0) ? v : SIMD_MM(add_ps)(acc, v);
+            if (q == nQuads - 1)
+            {
+                auto h = SIMD_MM(add_ps)(acc, SIMD_MM(movehl_ps)(acc, acc));
+                h = SIMD_MM(add_ss)(h, SIMD_MM(shuffle_ps)(h, h, SIMD_MM_SHUFFLE(1, 1, 1, 1)));
+                out[s] = SIMD_MM(cvtss_f32)(h);
+            }
+        });
+    }
+
+    float dPhaseTarget[nLanes]{};
+    float pulseWidthTarget[nLanes]{};
+
+  protected:
+    template <int blockSize, typename F> void forBlock(F &&emit)
+    {
+        const auto zero = SIMD_MM(setzero_ps)();
+        const auto one = SIMD_MM(set1_ps)(1.f);
+        const auto two = SIMD_MM(set1_ps)(2.f);
+        const auto bsInv = SIMD_MM(set1_ps)(1.f / blockSize);
+
+        SIMD_M128 ddp[nQuads], dpw[nQuads];
+        for (int q = 0; q < nQuads; ++q)
+        {
+            auto tdp = SIMD_MM(loadu_ps)(dPhaseTarget + q * 4);
+            auto tpw = SIMD_MM(loadu_ps)(pulseWidthTarget + q * 4);
+            if (snapToTargets)
+            {
+                dPhase[q] = tdp;
+                pulseWidth[q] = tpw;
+            }
+            ddp[q] = SIMD_MM(mul_ps)(SIMD_MM(sub_ps)(tdp, dPhase[q]), bsInv);
+            dpw[q] = SIMD_MM(mul_ps)(SIMD_MM(sub_ps)(tpw, pulseWidth[q]), bsInv);
+        }
+        snapToTargets = false;
+
+        auto saw = [&](SIMD_M128I ph, SIMD_M128 dp, SIMD_M128 rdp) {
+            auto p = toUnit(ph);
+            auto over = SIMD_MM(mul_ps)(
+                SIMD_MM(max_ps)(SIMD_MM(sub_ps)(SIMD_MM(add_ps)(p, dp), one), zero), rdp);
+            auto under = SIMD_MM(mul_ps)(SIMD_MM(max_ps)(SIMD_MM(sub_ps)(dp, p), zero), rdp);
+            auto res = SIMD_MM(sub_ps)(SIMD_MM(mul_ps)(p, two), one);
+            res = SIMD_MM(sub_ps)(res, SIMD_MM(mul_ps)(over, over));
+            return SIMD_MM(add_ps)(res, SIMD_MM(mul_ps)(under, under));
+        };
+
+        for (int s = 0; s < blockSize; ++s)
+        {
+            for (int q = 0; q < nQuads; ++q)
+            {
+                auto dp = dPhase[q];
+                auto rdp = SIMD_MM(div_ps)(one, dp);
+                auto v = saw(phase[q], dp, rdp);
+                if constexpr (isPulse)
+                {
+                    auto ph2 = SIMD_MM(add_epi32)(phase[q], toFixed(pulseWidth[q]));
+                    v = SIMD_MM(sub_ps)(v, saw(ph2, dp, rdp));
+                    pulseWidth[q] = SIMD_MM(add_ps)(pulseWidth[q], dpw[q]);
+                }
+                emit(q, s, v);
+
+                phase[q] = SIMD_MM(add_epi32)(phase[q], toFixed(dp));
+                dPhase[q] = SIMD_MM(add_ps)(dp, ddp[q]);
+            }
+        }
+    }
+
+    // [0,1] to 32 bit fixed point in two 16 bit halves, so small increments keep every bit
+    static SIMD_M128I toFixed(SIMD_M128 x)
+    {
+        const auto m16 = SIMD_MM(set1_ps)(65536.f);
+        auto xs = SIMD_MM(mul_ps)(x, m16);
+        auto hi = SIMD_MM(cvttps_epi32)(xs);
+        auto frac = SIMD_MM(sub_ps)(xs, SIMD_MM(cvtepi32_ps)(hi));
+        auto lo = SIMD_MM(cvttps_epi32)(SIMD_MM(mul_ps)(frac, m16));
+        return SIMD_MM(add_epi32)(SIMD_MM(slli_epi32)(hi, 16), lo);
+    }
+    static uint32_t toFixed(float x) { return (uint32_t)((double)x * 4294967296.0); }
+
+    // the top 24 bits convert exactly
+    static SIMD_M128 toUnit(SIMD_M128I ph)
+    {
+        return SIMD_MM(mul_ps)(SIMD_MM(cvtepi32_ps)(SIMD_MM(srli_epi32)(ph, 8)),
+                               SIMD_MM(set1_ps)(1.f / 16777216.f));
+    }
+
+    SIMD_M128I phase[nQuads];
+    SIMD_M128 dPhase[nQuads], pulseWidth[nQuads];
+    bool snapToTargets{true};
+};
+
+template <int nLanes> using DPWSawOscillatorBank = DPWOscillatorBank<nLanes, false>;
+template <int nLanes> using DPWPulseOscillatorBank = DPWOscillatorBank<nLanes, true>;
 } // namespace sst::basic_blocks::dsp
 
 #endif // INCLUDE_SST_BASIC_BLOCKS_DSP_DPWSAWPULSEOSCILLATOR_H
@@ -38,25 +38,110 @@
 #include "SmoothingStrategies.h"
 #include <unordered_map>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <cmath>
+#include <cstring>
+#include "sst/basic-blocks/simd/setup.h"
 
 namespace sst::basic_blocks::dsp
 {
 
+/*
+ * The blep pole data for a sample rate, shared by every oscillator at that rate. The
+ * standard rates from 44.1k to 384k are built together on first use (a function static,
+ * so that is thread safe) and never change after; bleps only hold a const pointer to them.
+ * Other rates go in a small cache which readers scan without locking; only inserting a rate
+ * we haven't seen takes a lock and allocates, so call prepareEBOscillators off the audio
+ * thread for unusual rates and the audio thread lookups will neither lock nor allocate.
+ */
 struct CoeffHolder
 {
     using payload_t = signalsmith::blep::EllipticBlepPoles<float>;
 
-    static payload_t &getPoleDataForSampleRate(double sampleRate)
+    static constexpr size_t standardRates[]{44100,  48000,  88200,  96000,
+                                            176400, 192000, 352800, 384000};
+    static constexpr size_t numStandardRates{sizeof(standardRates) / sizeof(size_t)};
+
+    static const payload_t &getPoleDataForSampleRate(double sampleRate)
     {
-        static std::unordered_map<size_t, payload_t> data;
+        auto key = (size_t)sampleRate;
 
-        auto lu = data.find((size_t)sampleRate);
-        if (lu == data.end())
+        auto &sp = standardPoles();
+        for (size_t i = 0; i < numStandardRates; ++i)
         {
-            data[(size_t)sampleRate] = payload_t(false, sampleRate);
-            lu = data.find((size_t)sampleRate);
+            if (standardRates[i] == key)
+                return *sp[i];
         }
-        return lu->second;
+        return otherRates().get(key);
+    }
+
+  protected:
+    static std::array<std::unique_ptr<payload_t>, numStandardRates> &standardPoles()
+    {
+        static std::array<std::unique_ptr<payload_t>, numStandardRates> res = []() {
+            std::array<std::unique_ptr<payload_t>, numStandardRates> r;
+            for (size_t i = 0; i < numStandardRates; ++i)
+                r[i] = std::make_unique<payload_t>(false, standardRates[i]);
+            return r;
+        }();
+        return res;
+    }
+
+    struct RateCache
+    {
+        static constexpr size_t capacity{32};
+
+        // slots below count are published and never change, so readers need no lock
+        size_t keys[capacity]{};
+        std::unique_ptr<payload_t> data[capacity];
+        std::atomic<size_t> count{0};
+
+        // past capacity, which takes a lot of distinct odd rates, we fall back to locking
+        std::mutex insertMutex;
+        std::deque<std::pair<size_t, payload_t>> overflow;
+
+        payload_t &get(size_t key)
+        {
+            auto n = count.load(std::memory_order_acquire);
+            for (size_t i = 0; i < n; ++i)
+            {
+                if (keys[i] == key)
+                    return *data[i];
+            }
+
+            std::lock_guard<std::mutex> g(insertMutex);
+            // someone may have inserted it while we waited
+            n = count.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < n; ++i)
+            {
+                if (keys[i] == key)
+                    return *data[i];
+            }
+            if (n < capacity)
+            {
+                keys[n] = key;
+                data[n] = std::make_unique<payload_t>(false, key);
+                count.store(n + 1, std::memory_order_release);
+                return *data[n];
+            }
+
+            for (auto &[k, p] : overflow)
+            {
+                if (k == key)
+                    return p;
+            }
+            return overflow.emplace_back(key, payload_t(false, key)).second;
+        }
+    };
+
+    static RateCache &otherRates()
+    {
+        static RateCache cache;
+        return cache;
     }
 };
 
@@ -141,6 +226,70 @@ template <typename Impl, typename SmoothingStrategy = LagSmoothingStrategy> stru
      */
     void setSyncRatio(float syncRatio) { SmoothingStrategy::setTarget(sratio, syncRatio); }
 
+    /*
+     * Generate one sample. Each oscillator implements advance, which moves the phases on,
+     * adds any bleps to the blep it is handed and returns the naive waveform value, and
+     * may override finish, which post-processes the filtered value and moves the smoothers
+     * on. Splitting it this way lets EBUnisonBank run the bleps and allpasses of many
+     * voices together.
+     */
+    float step()
+    {
+        auto &impl = *static_cast<Impl *>(this);
+
+        this->blep.step();
+
+        float result = impl.advance(this->blep);
+
+        result += this->blep.get();     // add in BLEP residue
+        result = this->allpass(result); // (optional) phase correction
+
+        return impl.finish(result);
+    }
+
+    float finish(float result)
+    {
+        SmoothingStrategy::process(this->dphase);
+        SmoothingStrategy::process(this->sratio);
+        return result;
+    }
+
+    /*
+     * Generate a block of BS samples. If the smoothers have settled (the usual case of a
+     * note holding pitch) we skip processing them, run the blep and oscillator over the
+     * block, then the allpass and finishBlock over the whole block in separate passes.
+     * Otherwise this is just BS calls to step.
+     */
+    template <int BS> void fillBlock(float *out)
+    {
+        auto &impl = *static_cast<Impl *>(this);
+
+        if (!impl.settleSmoothers())
+        {
+            for (int i = 0; i < BS; ++i)
+                out[i] = step();
+            return;
+        }
+
+        for (int i = 0; i < BS; ++i)
+        {
+            this->blep.step();
+            auto naive = impl.advance(this->blep);
+            out[i] = naive + this->blep.get();
+        }
+        for (int i = 0; i < BS; ++i)
+            out[i] = this->allpass(out[i]);
+
+        impl.finishBlock(out, BS);
+    }
+
+    bool settleSmoothers()
+    {
+        return SmoothingStrategy::settle(this->dphase) && SmoothingStrategy::settle(this->sratio);
+    }
+
+    void finishBlock(float *, int) {}
+
   protected:
     /*
      * At very high (above nyquist) frequencies we can end up occasionally
@@ -154,7 +303,7 @@ template <typename Impl, typename SmoothingStrategy = LagSmoothingStrategy> stru
      * any of our algorithms here ever generate an exact 1.
      */
     inline float csip(float sip) { return std::clamp(sip, 0.f, 0.999999f); }
-    void syncTurnaroundCorrection(float freq, float srval)
+    template <typename Blep> void syncTurnaroundCorrection(Blep &blep, float freq, float srval)
     {
         float samplesInPast = (this->phase - 1) / (freq);
         float syncSamplesInPast = samplesInPast * srval;
@@ -165,7 +314,7 @@ template <typename Impl, typename SmoothingStrategy = LagSmoothingStrategy> stru
 
         float changeAtTurnaround = newValueAtTurnaround - valueAtTurnaround;
 
-        this->blep.add(changeAtTurnaround, 1, this->csip(samplesInPast));
+        blep.add(changeAtTurnaround, 1, this->csip(samplesInPast));
     }
 
     signalsmith::blep::EllipticBlep<float> blep;
@@ -181,7 +330,7 @@ template <typename Impl, typename SmoothingStrategy = LagSmoothingStrategy> stru
 template <typename SmoothingStrategy = LagSmoothingStrategy>
 struct EBSaw : EBOscillatorBase<EBSaw<SmoothingStrategy>, SmoothingStrategy>
 {
-    float step()
+    template <typename Blep> float advance(Blep &blep)
     {
         auto freq = SmoothingStrategy::getValue(this->dphase);
         auto srval = SmoothingStrategy::getValue(this->sratio);
@@ -189,11 +338,9 @@ struct EBSaw : EBOscillatorBase<EBSaw<SmoothingStrategy>, SmoothingStrategy>
         this->phase += freq;
         this->sphase += freq * srval;
 
-        this->blep.step();
-
         if (this->phase >= 1)
         {
-            this->syncTurnaroundCorrection(freq, srval);
+            this->syncTurnaroundCorrection(blep, freq, srval);
             this->phase -= 1;
             this->sphase = this->phase * srval;
         }
@@ -206,19 +353,10 @@ struct EBSaw : EBOscillatorBase<EBSaw<SmoothingStrategy>, SmoothingStrategy>
             auto dv = lastSampleValue - thisSampleValue;
 
             this->sphase = (this->sphase - 1);
-            this->blep.add(-2, 1, this->csip(samplesInPast));
+            blep.add(-2, 1, this->csip(samplesInPast));
         }
 
-        float result = valueAt(this->sphase); // naive sawtooth
-
-        result += this->blep.get(); // add in BLEP residue
-
-        result = this->allpass(result); // (optional) phase correction
-
-        SmoothingStrategy::process(this->dphase);
-        SmoothingStrategy::process(this->sratio);
-
-        return result;
+        return valueAt(this->sphase); // naive sawtooth
     }
 
     static float valueAt(float sphase) { return 2 * sphase - 1; }
@@ -227,7 +365,7 @@ struct EBSaw : EBOscillatorBase<EBSaw<SmoothingStrategy>, SmoothingStrategy>
 template <typename SmoothingStrategy = LagSmoothingStrategy>
 struct EBTri : EBOscillatorBase<EBTri<SmoothingStrategy>, SmoothingStrategy>
 {
-    float step()
+    template <typename Blep> float advance(Blep &blep)
     {
         auto freq = SmoothingStrategy::getValue(this->dphase);
         auto srval = SmoothingStrategy::getValue(this->sratio);
@@ -235,14 +373,12 @@ struct EBTri : EBOscillatorBase<EBTri<SmoothingStrategy>, SmoothingStrategy>
         this->phase += freq;
         this->sphase += freq * srval;
 
-        this->blep.step();
-
         // this turns us around externally
         if (this->phase >= 1)
         {
             if (this->sphase < 1)
             {
-                this->syncTurnaroundCorrection(freq, srval);
+                this->syncTurnaroundCorrection(blep, freq, srval);
             }
 
             this->phase -= 1;
@@ -256,25 +392,17 @@ struct EBTri : EBOscillatorBase<EBTri<SmoothingStrategy>, SmoothingStrategy>
         {
             float samplesInPast = (this->sphase - 0.25) / (srval * freq);
             auto dDeriv = 8 * srval * freq;
-            this->blep.add(dDeriv, 2, this->csip(samplesInPast));
+            blep.add(dDeriv, 2, this->csip(samplesInPast));
         }
         else if (srval * freq < 0.25 && lastSPhase < 0.75 && this->sphase >= 0.75)
         {
             float samplesInPast = (this->sphase - 0.75) / (srval * freq);
             auto dDeriv = -8 * srval * freq;
-            this->blep.add(dDeriv, 2, this->csip(samplesInPast));
+            blep.add(dDeriv, 2, this->csip(samplesInPast));
         }
 
         lastSPhase = this->sphase;
-        float result = valueAt(this->sphase); // naive sawtooth
-
-        result += this->blep.get();     // add in BLEP residue
-        result = this->allpass(result); // (optional) phase correction
-
-        SmoothingStrategy::process(this->dphase);
-        SmoothingStrategy::process(this->sratio);
-
-        return result;
+        return valueAt(this->sphase); // naive sawtooth
     }
     static float valueAt(float sphase)
     {
@@ -291,7 +419,7 @@ struct EBTri : EBOscillatorBase<EBTri<SmoothingStrategy>, SmoothingStrategy>
 template <typename SmoothingStrategy = LagSmoothingStrategy>
 struct EBApproxSin : EBOscillatorBase<EBApproxSin<SmoothingStrategy>, SmoothingStrategy>
 {
-    float step()
+    template <typename Blep> float advance(Blep &blep)
     {
         auto freq = SmoothingStrategy::getValue(this->dphase);
         auto srval = SmoothingStrategy::getValue(this->sratio);
@@ -299,14 +427,12 @@ struct EBApproxSin : EBOscillatorBase<EBApproxSin<SmoothingStrategy>, SmoothingS
         this->phase += freq;
         this->sphase += freq * srval;
 
-        this->blep.step();
-
         // this turns us around externally
         if (this->phase >= 1)
         {
             if (this->sphase < 1)
             {
-                this->syncTurnaroundCorrection(freq, srval);
+                this->syncTurnaroundCorrection(blep, freq, srval);
             }
             this->phase -= 1;
             this->sphase = this->phase * srval;
@@ -316,15 +442,7 @@ struct EBApproxSin : EBOscillatorBase<EBApproxSin<SmoothingStrategy>, SmoothingS
             this->sphase -= 1;
         }
 
-        float result = valueAt(this->sphase); // naive sawtooth
-
-        result += this->blep.get();     // add in BLEP residue
-        result = this->allpass(result); // (optional) phase correction
-
-        SmoothingStrategy::process(this->dphase);
-        SmoothingStrategy::process(this->sratio);
-
-        return result;
+        return valueAt(this->sphase); // naive sawtooth
     }
     static float valueAt(float sphase)
     {
@@ -343,7 +461,7 @@ struct EBApproxSin : EBOscillatorBase<EBApproxSin<SmoothingStrategy>, SmoothingS
 template <typename SmoothingStrategy = LagSmoothingStrategy>
 struct EBApproxSemiSin : EBOscillatorBase<EBApproxSemiSin<SmoothingStrategy>, SmoothingStrategy>
 {
-    float step()
+    template <typename Blep> float advance(Blep &blep)
     {
         // TODO: This needs a blep order 2 correction for the derivative change at sphase==0
         auto freq = SmoothingStrategy::getValue(this->dphase);
@@ -352,8 +470,6 @@ struct EBApproxSemiSin : EBOscillatorBase<EBApproxSemiSin<SmoothingStrategy>, Sm
         this->phase += freq;
         this->sphase += freq * srval;
 
-        this->blep.step();
-
         if (this->sphase >= 1)
         {
             // so at this point we are moving from pi/2 sin(pi x) the derivative
@@ -362,7 +478,7 @@ struct EBApproxSemiSin : EBOscillatorBase<EBApproxSemiSin<SmoothingStrategy>, Sm
 
             float samplesInPast = (this->sphase - 1) / (srval * freq);
             auto dDeriv = M_PI * M_PI * srval * freq;
-            this->blep.add(dDeriv, 2, this->csip(samplesInPast));
+            blep.add(dDeriv, 2, this->csip(samplesInPast));
             this->sphase -= 1;
         }
 
@@ -371,21 +487,13 @@ struct EBApproxSemiSin : EBOscillatorBase<EBApproxSemiSin<SmoothingStrategy>, Sm
         {
             if (this->sphase < 1)
             {
-                this->syncTurnaroundCorrection(freq, srval);
+                this->syncTurnaroundCorrection(blep, freq, srval);
             }
             this->phase -= 1;
             this->sphase = this->phase * srval;
         }
 
-        float result = valueAt(this->sphase); // naive sawtooth
-
-        result += this->blep.get();     // add in BLEP residue
-        result = this->allpass(result); // (optional) phase correction
-
-        SmoothingStrategy::process(this->dphase);
-        SmoothingStrategy::process(this->sratio);
-
-        return result;
+        return valueAt(this->sphase); // naive sawtooth
     }
     static float valueAt(float sphase)
     {
@@ -416,7 +524,7 @@ struct EBPulse : EBOscillatorBase<EBPulse<SmoothingStrategy>, SmoothingStrategy>
 
     void setWidth(float w) { SmoothingStrategy::setTarget(width, std::clamp(w, 0.01f, 0.99f)); }
 
-    float step()
+    template <typename Blep> float advance(Blep &blep)
     {
         auto freq = SmoothingStrategy::getValue(this->dphase);
         auto srval = SmoothingStrategy::getValue(this->sratio);
@@ -425,8 +533,6 @@ struct EBPulse : EBOscillatorBase<EBPulse<SmoothingStrategy>, SmoothingStrategy>
         this->phase += freq;
         this->sphase += freq * srval;
 
-        this->blep.step();
-
         // sync turnaround
         if (this->phase >= 1)
         {
@@ -434,7 +540,7 @@ struct EBPulse : EBOscillatorBase<EBPulse<SmoothingStrategy>, SmoothingStrategy>
             {
                 float samplesInPast = (this->phase - 1) / (freq);
                 // low to high
-                this->blep.add(2, 1, this->csip(samplesInPast));
+                blep.add(2, 1, this->csip(samplesInPast));
             }
 
             this->phase -= 1;
@@ -449,7 +555,7 @@ struct EBPulse : EBOscillatorBase<EBPulse<SmoothingStrategy>, SmoothingStrategy>
 
             level = -1;
             // high to low
-            this->blep.add(-2, 1, this->csip(samplesInPast));
+            blep.add(-2, 1, this->csip(samplesInPast));
         }
 
         if (this->sphase > 1)
@@ -458,17 +564,17 @@ struct EBPulse : EBOscillatorBase<EBPulse<SmoothingStrategy>, SmoothingStrategy>
 
             level = 1;
             // low to high
-            this->blep.add(2, 1, this->csip(samplesInPast));
+            blep.add(2, 1, this->csip(samplesInPast));
             this->sphase -= 1;
         }
 
-        float result = level;
-
-        result += this->blep.get();     // add in BLEP residue
-        result = this->allpass(result); // (optional) phase correction
+        return level;
+    }
 
+    float finish(float result)
+    {
         // Remove DC offset: pulse wave integral is width * 1 + (1-width) * (-1) = 2*width - 1
-        result -= (2.0f * wval - 1.0f);
+        result -= (2.0f * SmoothingStrategy::getValue(this->width) - 1.0f);
 
         SmoothingStrategy::process(this->dphase);
         SmoothingStrategy::process(this->sratio);
@@ -477,10 +583,174 @@ struct EBPulse : EBOscillatorBase<EBPulse<SmoothingStrategy>, SmoothingStrategy>
         return result;
     }
 
+    bool settleSmoothers()
+    {
+        return EBOscillatorBase<EBPulse<SmoothingStrategy>, SmoothingStrategy>::settleSmoothers() &&
+               SmoothingStrategy::settle(this->width);
+    }
+
+    void finishBlock(float *out, int n)
+    {
+        auto dc = 2.0f * SmoothingStrategy::getValue(this->width) - 1.0f;
+        for (int i = 0; i < n; ++i)
+            out[i] -= dc;
+    }
+
   protected:
     // SmoothingStrategy::smoothValue_t width;
     typename SmoothingStrategy::smoothValue_t width;
     float level{1};
 };
+
+/*
+ * N voices of one EB oscillator (EBSaw, EBPulse, EBTri, ...) for unison and supersaws.
+ * Each voice keeps its own phase logic, but the blep filter states and allpasses of all
+ * the voices are held structure-of-arrays, so the per sample pole rotations, blep
+ * residue sums and allpass are done for four voices per SIMD op. Bleps are still added
+ * per voice when that voice has a discontinuity. Each voice produces the same output as
+ * a lone oscillator with the same settings.
+ *
+ * Configure the voices through voices[v] (setFrequency, setSyncRatio, setWidth etc.)
+ * but use the bank's setSampleRate and reset, since those own the blep state.
+ */
+template <typename Impl, int N> struct EBUnisonBank
+{
+    static_assert(N > 0);
+    static constexpr int nLanes = (N + 3) & ~3;
+    static constexpr int nVectors = nLanes / 4;
+
+    using poles_t = CoeffHolder::payload_t;
+    using coeffs_t = signalsmith::blep::EllipticBlepCoeffs<float>;
+    static constexpr size_t nPoles = poles_t::count;
+    static constexpr size_t apOrder = coeffs_t::allpassOrder;
+
+    Impl voices[N];
+
+    EBUnisonBank()
+    {
+        auto ac = coeffs_t().allpassCoeffs;
+        for (size_t i = 0; i < apOrder; ++i)
+            apCoeffs[i] = ac[i];
+        setPoles(44100);
+        reset();
+    }
+
+    void setSampleRate(double sampleRate)
+    {
+        for (auto &v : voices)
+            v.setSampleRate(sampleRate);
+        setPoles(sampleRate);
+    }
+
+    void reset()
+    {
+        for (auto &v : voices)
+            v.reset();
+        memset(stateRe, 0, sizeof(stateRe));
+        memset(stateIm, 0, sizeof(stateIm));
+        memset(apState, 0, sizeof(apState));
+    }
+
+    // One sample for every voice into out[0..N)
+    void step(float *out)
+    {
+        // EllipticBlep::step for every voice: rotate each pole's state by the one sample pole
+        for (size_t i = 0; i < nPoles; ++i)
+        {
+            auto pr = SIMD_MM(set1_ps)(stepRe[i]);
+            auto pi = SIMD_MM(set1_ps)(stepIm[i]);
+            for (int g = 0; g < nVectors; ++g)
+            {
+                auto re = SIMD_MM(load_ps)(&stateRe[i][4 * g]);
+                auto im = SIMD_MM(load_ps)(&stateIm[i][4 * g]);
+                auto nre = SIMD_MM(sub_ps)(SIMD_MM(mul_ps)(re, pr), SIMD_MM(mul_ps)(im, pi));
+                auto nim = SIMD_MM(add_ps)(SIMD_MM(mul_ps)(re, pi), SIMD_MM(mul_ps)(im, pr));
+                SIMD_MM(store_ps)(&stateRe[i][4 * g], nre);
+                SIMD_MM(store_ps)(&stateIm[i][4 * g], nim);
+            }
+        }
+
+        float values alignas(16)[nLanes]{};
+        for (int v = 0; v < N; ++v)
+        {
+            VoiceBlep vb{*this, v};
+            values[v] = voices[v].advance(vb);
+        }
+
+        for (int g = 0; g < nVectors; ++g)
+        {
+            // EllipticBlep::get, then the allpass, across four voices
+            auto x = SIMD_MM(load_ps)(&values[4 * g]);
+            for (size_t i = 0; i < nPoles; ++i)
+                x = SIMD_MM(add_ps)(x, SIMD_MM(load_ps)(&stateRe[i][4 * g]));
+
+            auto y = SIMD_MM(add_ps)(SIMD_MM(load_ps)(&apState[0][4 * g]),
+                                     SIMD_MM(mul_ps)(x, SIMD_MM(set1_ps)(apCoeffs[apOrder - 1])));
+            for (size_t i = 0; i < apOrder - 1; ++i)
+            {
+                auto ns = SIMD_MM(add_ps)(
+                    SIMD_MM(load_ps)(&apState[i + 1][4 * g]),
+                    SIMD_MM(mul_ps)(x, SIMD_MM(set1_ps)(apCoeffs[apOrder - 2 - i])));
+                ns = SIMD_MM(sub_ps)(ns, SIMD_MM(mul_ps)(y, SIMD_MM(set1_ps)(apCoeffs[i])));
+                SIMD_MM(store_ps)(&apState[i][4 * g], ns);
+            }
+            SIMD_MM(store_ps)(
+                &apState[apOrder - 1][4 * g],
+                SIMD_MM(sub_ps)(x, SIMD_MM(mul_ps)(y, SIMD_MM(set1_ps)(apCoeffs[apOrder - 1]))));
+            SIMD_MM(store_ps)(&values[4 * g], y);
+        }
+
+        for (int v = 0; v < N; ++v)
+            out[v] = voices[v].finish(values[v]);
+    }
+
+  protected:
+    // What advance sees as the blep for voice v; EllipticBlep::add on that voice's lanes
+    struct VoiceBlep
+    {
+        EBUnisonBank &bank;
+        int v;
+
+        void add(float amount, size_t blepOrder, float samplesInPast)
+        {
+            if (blepOrder > poles_t::maxBlepOrder)
+                return;
+
+            const auto &p = *bank.poles;
+            const auto &bc = p.blepCoeffs[blepOrder];
+            float tableIndex = samplesInPast * p.partialStepCount;
+            size_t intIndex = std::floor(tableIndex);
+            float fracIndex = tableIndex - std::floor(tableIndex);
+
+            const auto &lowPoles = p.partialStepPoles[intIndex];
+            const auto &highPoles = p.partialStepPoles[intIndex + 1];
+            for (size_t i = 0; i < nPoles; ++i)
+            {
+                auto lerpPole = lowPoles[i] + (highPoles[i] - lowPoles[i]) * fracIndex;
+                auto d = bc[i] * lerpPole * amount;
+                bank.stateRe[i][v] += d.real();
+                bank.stateIm[i][v] += d.imag();
+            }
+        }
+    };
+
+    void setPoles(double sampleRate)
+    {
+        poles = &CoeffHolder::getPoleDataForSampleRate(sampleRate);
+        const auto &lp = poles->partialStepPoles.back();
+        for (size_t i = 0; i < nPoles; ++i)
+        {
+            stepRe[i] = lp[i].real();
+            stepIm[i] = lp[i].imag();
+        }
+    }
+
+    const poles_t *poles{nullptr};
+    float stepRe[nPoles], stepIm[nPoles];
+    float apCoeffs[apOrder];
+
+    float stateRe alignas(16)[nPoles][nLanes], stateIm alignas(16)[nPoles][nLanes];
+    float apState alignas(16)[apOrder][nLanes];
+};
 } // namespace sst::basic_blocks::dsp
 #endif // ELLIPTICBLEPOSCILLATORS_H
@@ -34,9 +34,17 @@
  * willing to have it re-used in a GPL3 or MIT/BSD context.
  *
  * If you do use this in a GPL3 context, you will need to copy,
- * strip the single include and replace the `sum_ps_to_float`
- * call below with either an hadd if you are SSE3 or higher or
- * an appropriate reduction operator from your toolkit.
+ * strip the two sst includes and replace the `sum_ps_to_float`
+ * calls below with either an hadd if you are SSE3 or higher or
+ * an appropriate reduction operator from your toolkit. Likewise
+ * the `hsum4_ps(a, b, c, d)` calls, which return the horizontal
+ * sums {sum(a), sum(b), sum(c), sum(d)} in one register, can be
+ * replaced with hadd_ps(hadd_ps(a, b), hadd_ps(c, d)) on SSE3 or
+ * with
+ *
+ *   ab = add(unpacklo(a, b), unpackhi(a, b));
+ *   cd = add(unpacklo(c, d), unpackhi(c, d));
+ *   return add(movelh(ab, cd), movehl(cd, ab));
  *
  * But basically: Need to resample 48k to variable rate with
  * a small window and want to use this? Go for it!
@@ -50,6 +58,7 @@
 #include <utility>
 #include <cmath>
 #include <cstring>
+#include <memory>
 #include "sst/basic-blocks/simd/setup.h"
 #include "sst/basic-blocks/mechanics/simd-ops.h"
 
@@ -59,68 +68,130 @@ namespace sst::basic_blocks::dsp
  * See https://en.wikipedia.org/wiki/Lanczos_resampling
  */
 
-template <int blockSize> struct LanczosResampler
+/*
+ * The interpolated kernel tables for a given order. They depend on nothing but the order
+ * so every resampler of that order (whatever its block size or channel count) shares one
+ * immutable copy, built on first use behind a function static so construction is thread
+ * safe. Rows are padded with zero taps to a multiple of four so they load as whole SIMD
+ * registers.
+ */
+template <int order> struct LanczosTables
 {
-    static constexpr size_t A = 4;
-    static constexpr size_t BUFFER_SZ = 4096;
+    static_assert(order >= 2 && order <= 8, "Lanczos order should be between 2 and 8");
+
+    static constexpr size_t A = order;
     static constexpr size_t filterWidth = A * 2;
+    static constexpr size_t paddedWidth = (filterWidth + 3) & ~(size_t)3;
+    static constexpr size_t nVectors = paddedWidth / 4;
     static constexpr size_t tableObs = 8192;
     static constexpr double dx = 1.0 / (tableObs);
 
-    // Fixme: Make this static and shared
-    static float lanczosTable alignas(16)[tableObs + 1][filterWidth], lanczosTableDX
-        alignas(16)[tableObs + 1][filterWidth];
-    static bool tablesInitialized;
+    float lanczosTable alignas(16)[tableObs + 1][paddedWidth];
+    float lanczosTableDX alignas(16)[tableObs + 1][paddedWidth];
 
-    // This is a stereo resampler
-    float input[2][BUFFER_SZ * 2];
-    int wp = 0;
-    float sri, sro;
-    double phaseI, phaseO, dPhaseI, dPhaseO;
-
-    inline double kernel(double x)
+    static inline double kernel(double x)
     {
         if (fabs(x) < 1e-7)
             return 1;
         return A * std::sin(M_PI * x) * std::sin(M_PI * x / A) / (M_PI * M_PI * x * x);
     }
 
-    LanczosResampler(float inputRate, float outputRate) : sri(inputRate), sro(outputRate)
+    static const LanczosTables &get()
     {
-        phaseI = 0;
-        phaseO = 0;
+        static const std::unique_ptr<LanczosTables> tables = []() {
+            auto res = std::make_unique<LanczosTables>();
+            res->build();
+            return res;
+        }();
+        return *tables;
+    }
 
-        dPhaseI = 1.0;
-        dPhaseO = sri / sro;
+    /*
+     * The interpolated kernel for a read xBack behind the write position wp of a buffer of
+     * size bufferSize (stored twice so reads can wrap). It applies to buffer samples
+     * idx0 - A ... idx0 - A + paddedWidth - 1, which is what we return.
+     */
+    template <size_t bufferSize>
+    inline int kernelAt(int wp, double xBack, SIMD_M128 (&f)[nVectors]) const
+    {
+        double p0 = wp - xBack;
+        int idx0 = floor(p0);
+        double off0 = 1.0 - (p0 - idx0);
 
-        memset(input[0], 0, 2 * BUFFER_SZ * sizeof(float));
-        memset(input[1], 0, 2 * BUFFER_SZ * sizeof(float));
-        if (!tablesInitialized)
+        idx0 = (idx0 + bufferSize) & (bufferSize - 1);
+        idx0 += (idx0 <= (int)A) * bufferSize;
+
+        double off0byto = off0 * tableObs;
+        int tidx = (int)(off0byto);
+        double fidx = (off0byto - tidx);
+
+        auto fl = SIMD_MM(set1_ps)((float)fidx);
+        for (size_t v = 0; v < nVectors; ++v)
         {
-            for (size_t t = 0; t < tableObs + 1; ++t)
-            {
-                double x0 = dx * t;
-                for (size_t i = 0; i < filterWidth; ++i)
-                {
-                    double x = x0 + i - A;
-                    lanczosTable[t][i] = kernel(x);
-                }
-            }
-            for (size_t t = 0; t < tableObs; ++t)
+            auto f0 = SIMD_MM(load_ps)(&lanczosTable[tidx][4 * v]);
+            auto df0 = SIMD_MM(load_ps)(&lanczosTableDX[tidx][4 * v]);
+            f[v] = SIMD_MM(add_ps)(f0, SIMD_MM(mul_ps)(df0, fl));
+        }
+
+        return idx0 - (int)A;
+    }
+
+  private:
+    void build()
+    {
+        for (size_t t = 0; t < tableObs + 1; ++t)
+        {
+            double x0 = dx * t;
+            for (size_t i = 0; i < paddedWidth; ++i)
             {
-                for (size_t i = 0; i < filterWidth; ++i)
-                {
-                    // t+1 is fine here since the input goes up to tableObs + 1 size
-                    lanczosTableDX[t][i] = lanczosTable[t + 1][i] - lanczosTable[t][i];
-                }
+                double x = x0 + i - A;
+                lanczosTable[t][i] = i < filterWidth ? kernel(x) : 0.f;
             }
-            for (size_t i = 0; i < filterWidth; ++i)
+        }
+        for (size_t t = 0; t < tableObs; ++t)
+        {
+            for (size_t i = 0; i < paddedWidth; ++i)
             {
-                // Wrap at the end - deriv is the same
-                lanczosTableDX[tableObs][i] = lanczosTableDX[0][i];
+                // t+1 is fine here since the input goes up to tableObs + 1 size
+                lanczosTableDX[t][i] = lanczosTable[t + 1][i] - lanczosTable[t][i];
             }
-            tablesInitialized = true;
         }
+        for (size_t i = 0; i < paddedWidth; ++i)
+        {
+            // Wrap at the end - deriv is the same
+            lanczosTableDX[tableObs][i] = lanczosTableDX[0][i];
+        }
+    }
+};
+
+template <int blockSize, int order = 4> struct LanczosResampler
+{
+    using tables_t = LanczosTables<order>;
+    static constexpr size_t A = tables_t::A;
+    static constexpr size_t BUFFER_SZ = 4096;
+    static constexpr size_t filterWidth = tables_t::filterWidth;
+    static constexpr size_t nVectors = tables_t::nVectors;
+    static constexpr size_t tableObs = tables_t::tableObs;
+    static constexpr double dx = tables_t::dx;
+
+    // This is a stereo resampler
+    float input[2][BUFFER_SZ * 2];
+    int wp = 0;
+    float sri, sro;
+    double phaseI, phaseO, dPhaseI, dPhaseO;
+    const tables_t *tables{nullptr};
+
+    LanczosResampler(float inputRate, float outputRate)
+        : sri(inputRate), sro(outputRate), tables(&tables_t::get())
+    {
+        phaseI = 0;
+        phaseO = 0;
+
+        dPhaseI = 1.0;
+        dPhaseO = sri / sro;
+
+        memset(input[0], 0, 2 * BUFFER_SZ * sizeof(float));
+        memset(input[1], 0, 2 * BUFFER_SZ * sizeof(float));
     }
 
     inline void push(float fL, float fR)
@@ -156,38 +227,45 @@ template <int blockSize> struct LanczosResampler
         R = (1.0 - frac) * input[1][idx0] + frac * input[1][idx0 + 1];
     }
 
-    inline void read(double xBack, float &L, float &R) const
+    /*
+     * The kernel weighted taps for one channel; sum the lanes for the output. For the
+     * default order 4 this is the same two multiply and add as ever.
+     */
+    inline SIMD_M128 taps(int c, int start, const SIMD_M128 (&f)[nVectors]) const
     {
-        double p0 = wp - xBack;
-        int idx0 = floor(p0);
-        double off0 = 1.0 - (p0 - idx0);
-
-        idx0 = (idx0 + BUFFER_SZ) & (BUFFER_SZ - 1);
-        idx0 += (idx0 <= (int)A) * BUFFER_SZ;
-
-        double off0byto = off0 * tableObs;
-        int tidx = (int)(off0byto);
-        double fidx = (off0byto - tidx);
-
-        auto fl = SIMD_MM(set1_ps)((float)fidx);
-        auto f0 = SIMD_MM(load_ps)(&lanczosTable[tidx][0]);
-        auto df0 = SIMD_MM(load_ps)(&lanczosTableDX[tidx][0]);
-
-        f0 = SIMD_MM(add_ps)(f0, SIMD_MM(mul_ps)(df0, fl));
+        auto rv = SIMD_MM(mul_ps)(f[0], SIMD_MM(loadu_ps)(&input[c][start]));
+        for (size_t v = 1; v < nVectors; ++v)
+            rv = SIMD_MM(add_ps)(
+                rv, SIMD_MM(mul_ps)(f[v], SIMD_MM(loadu_ps)(&input[c][start + 4 * v])));
+        return rv;
+    }
 
-        auto f1 = SIMD_MM(load_ps)(&lanczosTable[tidx][4]);
-        auto df1 = SIMD_MM(load_ps)(&lanczosTableDX[tidx][4]);
-        f1 = SIMD_MM(add_ps)(f1, SIMD_MM(mul_ps)(df1, fl));
+    inline void read(double xBack, float &L, float &R) const
+    {
+        SIMD_M128 f[nVectors];
+        auto start = tables->template kernelAt<BUFFER_SZ>(wp, xBack, f);
 
-        auto d0 = SIMD_MM(loadu_ps)(&input[0][idx0 - A]);
-        auto d1 = SIMD_MM(loadu_ps)(&input[0][idx0]);
-        auto rv = SIMD_MM(add_ps)(SIMD_MM(mul_ps)(f0, d0), SIMD_MM(mul_ps)(f1, d1));
-        L = mechanics::sum_ps_to_float(rv);
+        L = mechanics::sum_ps_to_float(taps(0, start, f));
+        R = mechanics::sum_ps_to_float(taps(1, start, f));
+    }
 
-        d0 = SIMD_MM(loadu_ps)(&input[1][idx0 - A]);
-        d1 = SIMD_MM(loadu_ps)(&input[1][idx0]);
-        rv = SIMD_MM(add_ps)(SIMD_MM(mul_ps)(f0, d0), SIMD_MM(mul_ps)(f1, d1));
-        R = mechanics::sum_ps_to_float(rv);
+    /*
+     * Four consecutive outputs at xBack, xBack - dxBack, ... at once. Each output still gets
+     * its own kernel, but the per output dot products are reduced together with one
+     * transpose and add and written with a single store, rather than a horizontal sum each.
+     */
+    inline void read4(double xBack, double dxBack, float *L, float *R) const
+    {
+        SIMD_M128 lv[4], rv[4];
+        for (int j = 0; j < 4; ++j)
+        {
+            SIMD_M128 f[nVectors];
+            auto start = tables->template kernelAt<BUFFER_SZ>(wp, xBack - j * dxBack, f);
+            lv[j] = taps(0, start, f);
+            rv[j] = taps(1, start, f);
+        }
+        SIMD_MM(storeu_ps)(L, mechanics::hsum4_ps(lv[0], lv[1], lv[2], lv[3]));
+        SIMD_MM(storeu_ps)(R, mechanics::hsum4_ps(rv[0], rv[1], rv[2], rv[3]));
     }
 
     inline size_t inputsRequiredToGenerateOutputs(size_t desiredOutputs) const
@@ -229,18 +307,16 @@ template <int blockSize> struct LanczosResampler
     }
 };
 
-template <int bs>
-float LanczosResampler<bs>::lanczosTable alignas(
-    16)[LanczosResampler<bs>::tableObs + 1][LanczosResampler<bs>::filterWidth];
-template <int bs>
-float LanczosResampler<bs>::lanczosTableDX alignas(
-    16)[LanczosResampler<bs>::tableObs + 1][LanczosResampler<bs>::filterWidth];
-
-template <int bs> bool LanczosResampler<bs>::tablesInitialized{false};
-
-template <int bs> inline size_t LanczosResampler<bs>::populateNext(float *fL, float *fR, size_t max)
+template <int bs, int order>
+inline size_t LanczosResampler<bs, order>::populateNext(float *fL, float *fR, size_t max)
 {
     size_t populated = 0;
+    while (populated + 4 <= max && (phaseI - phaseO - 3 * dPhaseO) > A + 1)
+    {
+        read4((phaseI - phaseO), dPhaseO, fL + populated, fR + populated);
+        phaseO += 4 * dPhaseO;
+        populated += 4;
+    }
     while (populated < max && (phaseI - phaseO) > A + 1)
     {
         read((phaseI - phaseO), fL[populated], fR[populated]);
@@ -250,17 +326,24 @@ template <int bs> inline size_t LanczosResampler<bs>::populateNext(float *fL, fl
     return populated;
 }
 
-template <int bs> void LanczosResampler<bs>::populateNextBlockSize(float *fL, float *fR)
+template <int bs, int order>
+void LanczosResampler<bs, order>::populateNextBlockSize(float *fL, float *fR)
 {
     double r0 = phaseI - phaseO;
-    for (int i = 0; i < bs; ++i)
+    int i = 0;
+    for (; i + 4 <= bs; i += 4)
+    {
+        read4(r0 - i * dPhaseO, dPhaseO, fL + i, fR + i);
+    }
+    for (; i < bs; ++i)
     {
         read(r0 - i * dPhaseO, fL[i], fR[i]);
     }
     phaseO += bs * dPhaseO;
 }
 
-template <int bs> void LanczosResampler<bs>::populateNextBlockSizeLin(float *fL, float *fR)
+template <int bs, int order>
+void LanczosResampler<bs, order>::populateNextBlockSizeLin(float *fL, float *fR)
 {
     double r0 = phaseI - phaseO;
     for (int i = 0; i < bs; ++i)
@@ -270,7 +353,8 @@ template <int bs> void LanczosResampler<bs>::populateNextBlockSizeLin(float *fL,
     phaseO += bs * dPhaseO;
 }
 
-template <int bs> void LanczosResampler<bs>::populateNextBlockSizeZOH(float *fL, float *fR)
+template <int bs, int order>
+void LanczosResampler<bs, order>::populateNextBlockSizeZOH(float *fL, float *fR)
 {
     double r0 = phaseI - phaseO;
     for (int i = 0; i < bs; ++i)
@@ -279,14 +363,317 @@ template <int bs> void LanczosResampler<bs>::populateNextBlockSizeZOH(float *fL,
     }
     phaseO += bs * dPhaseO;
 }
-template <int bs> void LanczosResampler<bs>::populateNextBlockSizeOS(float *fL, float *fR)
+template <int bs, int order>
+void LanczosResampler<bs, order>::populateNextBlockSizeOS(float *fL, float *fR)
 {
     double r0 = phaseI - phaseO;
-    for (int i = 0; i < bs << 1; ++i)
+    int i = 0;
+    for (; i + 4 <= bs << 1; i += 4)
+    {
+        read4(r0 - i * dPhaseO, dPhaseO, fL + i, fR + i);
+    }
+    for (; i < bs << 1; ++i)
     {
         read(r0 - i * dPhaseO, fL[i], fR[i]);
     }
     phaseO += (bs << 1) * dPhaseO;
 }
+
+/*
+ * The same resampler for any number of channels, for surround and multi-output stems.
+ * The input is stored transposed in groups of four channels so a SIMD lane is a channel.
+ * The kernel is computed once per output sample and shared by every group, and each tap is
+ * a broadcast multiply-add across the group, so there is no horizontal sum per channel.
+ * Lanes past nChannels in the last group just carry zeros.
+ */
+template <int blockSize, int nChannels, int order = 4> struct MultiChannelLanczosResampler
+{
+    static_assert(nChannels > 0);
+    using tables_t = LanczosTables<order>;
+
+    static constexpr size_t A = tables_t::A;
+    static constexpr size_t BUFFER_SZ = LanczosResampler<blockSize, order>::BUFFER_SZ;
+    static constexpr size_t nVectors = tables_t::nVectors;
+    static constexpr int nGroups = (nChannels + 3) / 4;
+
+    float input alignas(16)[nGroups][BUFFER_SZ * 2][4];
+    int wp = 0;
+    float sri, sro;
+    double phaseI, phaseO, dPhaseI, dPhaseO;
+    const tables_t *tables{nullptr};
+
+    MultiChannelLanczosResampler(float inputRate, float outputRate)
+        : sri(inputRate), sro(outputRate), tables(&tables_t::get())
+    {
+        phaseI = 0;
+        phaseO = 0;
+
+        dPhaseI = 1.0;
+        dPhaseO = sri / sro;
+
+        memset(input, 0, sizeof(input));
+    }
+
+    // frame holds one sample for each of the nChannels channels
+    inline void push(const float *frame)
+    {
+        for (int g = 0; g < nGroups; ++g)
+        {
+            for (int l = 0; l < 4; ++l)
+            {
+                auto c = g * 4 + l;
+                auto v = c < nChannels ? frame[c] : 0.f;
+                input[g][wp][l] = v;
+                input[g][wp + BUFFER_SZ][l] = v; // this way we can always wrap
+            }
+        }
+        wp = (wp + 1) & (BUFFER_SZ - 1);
+        phaseI += dPhaseI;
+    }
+
+    template <int k> static inline SIMD_M128 broadcast(SIMD_M128 f)
+    {
+        return SIMD_MM(shuffle_ps)(f, f, SIMD_MM_SHUFFLE(k, k, k, k));
+    }
+
+    // The four channels of group g for a kernel from kernelAt
+    inline SIMD_M128 readGroup(int g, int start, const SIMD_M128 (&f)[nVectors]) const
+    {
+        auto r0 = SIMD_MM(setzero_ps)();
+        auto r1 = SIMD_MM(setzero_ps)();
+        for (size_t v = 0; v < nVectors; ++v)
+        {
+            const auto *d = &input[g][start + 4 * v][0];
+            r0 = SIMD_MM(add_ps)(r0, SIMD_MM(mul_ps)(broadcast<0>(f[v]), SIMD_MM(load_ps)(d)));
+            r1 = SIMD_MM(add_ps)(r1, SIMD_MM(mul_ps)(broadcast<1>(f[v]), SIMD_MM(load_ps)(d + 4)));
+            r0 = SIMD_MM(add_ps)(r0, SIMD_MM(mul_ps)(broadcast<2>(f[v]), SIMD_MM(load_ps)(d + 8)));
+            r1 = SIMD_MM(add_ps)(r1, SIMD_MM(mul_ps)(broadcast<3>(f[v]), SIMD_MM(load_ps)(d + 12)));
+        }
+        return SIMD_MM(add_ps)(r0, r1);
+    }
+
+    // out holds one sample for each of the nChannels channels
+    inline void read(double xBack, float *out) const
+    {
+        SIMD_M128 f[nVectors];
+        auto start = tables->template kernelAt<BUFFER_SZ>(wp, xBack, f);
+
+        for (int g = 0; g < nGroups; ++g)
+        {
+            float res alignas(16)[4];
+            SIMD_MM(store_ps)(res, readGroup(g, start, f));
+            for (int l = 0; l < 4 && g * 4 + l < nChannels; ++l)
+                out[g * 4 + l] = res[l];
+        }
+    }
+
+    inline size_t inputsRequiredToGenerateOutputs(size_t desiredOutputs) const
+    {
+        double res = A + 1 - (phaseI - phaseO - dPhaseO * desiredOutputs);
+        return (size_t)std::max(res + 1, 0.0);
+    }
+
+    // out[c] is the destination for channel c
+    size_t populateNext(float *const *out, size_t max)
+    {
+        size_t populated = 0;
+        float frame[nChannels];
+        while (populated < max && (phaseI - phaseO) > A + 1)
+        {
+            read((phaseI - phaseO), frame);
+            for (int c = 0; c < nChannels; ++c)
+                out[c][populated] = frame[c];
+            phaseO += dPhaseO;
+            populated++;
+        }
+        return populated;
+    }
+
+    /*
+     * As with the stereo version, this populates blockSize outputs without checking
+     * you have pushed enough input.
+     */
+    void populateNextBlockSize(float *const *out)
+    {
+        double r0 = phaseI - phaseO;
+        float frame[nChannels];
+        for (int i = 0; i < blockSize; ++i)
+        {
+            read(r0 - i * dPhaseO, frame);
+            for (int c = 0; c < nChannels; ++c)
+                out[c][i] = frame[c];
+        }
+        phaseO += blockSize * dPhaseO;
+    }
+
+    inline void advanceReadPointer(size_t n) { phaseO += n * dPhaseO; }
+    inline void snapOutToIn()
+    {
+        phaseO = 0;
+        phaseI = 0;
+    }
+
+    inline void renormalizePhases()
+    {
+        phaseI -= phaseO;
+        phaseO = 0;
+    }
+};
+
+/*
+ * Fixed integer ratio (2x and 4x) oversampling. With an integer ratio the kernel for each
+ * output only depends on which of the factor phases it lands on, so we keep one exact
+ * coefficient row per phase and step through the block with integer indices. There is no
+ * table interpolation and no double precision phase, and the tap sums reduce four outputs
+ * at a time like read4. The rows are shared per factor and order like LanczosTables.
+ */
+template <int factor, int order> struct LanczosPolyphaseTables
+{
+    static_assert(factor == 2 || factor == 4, "Polyphase resampling is for 2x or 4x");
+    using base_t = LanczosTables<order>;
+    static constexpr size_t A = base_t::A;
+
+    // Upsampling: output phase p of input n is the input interpolated at n - A + p / factor
+    static constexpr size_t upWidth = base_t::filterWidth;
+    static constexpr size_t upPaddedWidth = base_t::paddedWidth;
+    // Downsampling: the kernel stretched to the output rate, normalized for unity DC gain
+    static constexpr size_t downWidth = 2 * A * factor - 1;
+    static constexpr size_t downPaddedWidth = (downWidth + 3) & ~(size_t)3;
+
+    float up alignas(16)[factor][upPaddedWidth];
+    float down alignas(16)[downPaddedWidth];
+
+    static const LanczosPolyphaseTables &get()
+    {
+        static const std::unique_ptr<LanczosPolyphaseTables> tables = []() {
+            auto res = std::make_unique<LanczosPolyphaseTables>();
+            res->build();
+            return res;
+        }();
+        return *tables;
+    }
+
+  private:
+    void build()
+    {
+        for (int p = 0; p < factor; ++p)
+        {
+            for (size_t i = 0; i < upPaddedWidth; ++i)
+            {
+                up[p][i] = i < upWidth ? base_t::kernel(A - 1.0 - i + 1.0 * p / factor) : 0.f;
+            }
+        }
+
+        double sum{0};
+        for (size_t i = 0; i < downWidth; ++i)
+            sum += base_t::kernel((1.0 * i - (downWidth - 1) / 2) / factor);
+        for (size_t i = 0; i < downPaddedWidth; ++i)
+        {
+            down[i] = i < downWidth
+                          ? base_t::kernel((1.0 * i - (downWidth - 1) / 2) / factor) / sum
+                          : 0.f;
+        }
+    }
+};
+
+/*
+ * Stereo upsampling by factor. Each call to process takes blockSize inputs and writes
+ * blockSize * factor outputs, delayed by A input samples.
+ */
+template <int factor, int blockSize, int order = 4> struct LanczosPolyphaseUpsampler
+{
+    using tables_t = LanczosPolyphaseTables<factor, order>;
+    static constexpr size_t A = tables_t::A;
+    static constexpr size_t nVectors = tables_t::upPaddedWidth / 4;
+    static constexpr size_t historySize = tables_t::upWidth - 1;
+    static constexpr int outputSize = blockSize * factor;
+    static_assert(outputSize % 4 == 0);
+
+    float input alignas(16)[2][historySize + blockSize + 4];
+    const tables_t *tables{nullptr};
+
+    LanczosPolyphaseUpsampler() : tables(&tables_t::get()) { reset(); }
+
+    void reset() { memset(input, 0, sizeof(input)); }
+
+    void process(const float *inL, const float *inR, float *outL, float *outR)
+    {
+        memcpy(&input[0][historySize], inL, blockSize * sizeof(float));
+        memcpy(&input[1][historySize], inR, blockSize * sizeof(float));
+
+        for (int c = 0; c < 2; ++c)
+        {
+            auto *out = c == 0 ? outL : outR;
+            for (int o = 0; o < outputSize; o += 4)
+            {
+                SIMD_M128 acc[4];
+                for (int j = 0; j < 4; ++j)
+                {
+                    auto n = (o + j) / factor;
+                    const auto &row = tables->up[(o + j) % factor];
+                    const auto *d = &input[c][n];
+                    acc[j] = SIMD_MM(mul_ps)(SIMD_MM(load_ps)(row), SIMD_MM(loadu_ps)(d));
+                    for (size_t v = 1; v < nVectors; ++v)
+                        acc[j] = SIMD_MM(add_ps)(acc[j],
+                                                 SIMD_MM(mul_ps)(SIMD_MM(load_ps)(row + 4 * v),
+                                                                 SIMD_MM(loadu_ps)(d + 4 * v)));
+                }
+                SIMD_MM(storeu_ps)(out + o, mechanics::hsum4_ps(acc[0], acc[1], acc[2], acc[3]));
+            }
+            memmove(&input[c][0], &input[c][blockSize], historySize * sizeof(float));
+        }
+    }
+};
+
+/*
+ * Stereo downsampling by factor, the partner of LanczosPolyphaseUpsampler. Each call to
+ * process takes blockSize * factor inputs and writes blockSize outputs, delayed by A - 1
+ * output samples. The kernel is stretched to the output rate so it also band limits, and
+ * is only evaluated at the outputs we keep.
+ */
+template <int factor, int blockSize, int order = 4> struct LanczosPolyphaseDownsampler
+{
+    using tables_t = LanczosPolyphaseTables<factor, order>;
+    static constexpr size_t A = tables_t::A;
+    static constexpr size_t nVectors = tables_t::downPaddedWidth / 4;
+    static constexpr size_t historySize = tables_t::downWidth - 1;
+    static constexpr int inputSize = blockSize * factor;
+    static_assert(blockSize % 4 == 0);
+
+    float input alignas(16)[2][historySize + inputSize + 4];
+    const tables_t *tables{nullptr};
+
+    LanczosPolyphaseDownsampler() : tables(&tables_t::get()) { reset(); }
+
+    void reset() { memset(input, 0, sizeof(input)); }
+
+    void process(const float *inL, const float *inR, float *outL, float *outR)
+    {
+        memcpy(&input[0][historySize], inL, inputSize * sizeof(float));
+        memcpy(&input[1][historySize], inR, inputSize * sizeof(float));
+
+        const auto *row = tables->down;
+        for (int c = 0; c < 2; ++c)
+        {
+            auto *out = c == 0 ? outL : outR;
+            for (int o = 0; o < blockSize; o += 4)
+            {
+                SIMD_M128 acc[4];
+                for (int j = 0; j < 4; ++j)
+                {
+                    // the taps end on the last input of this output's group of factor
+                    const auto *d = &input[c][(o + j) * factor + factor - 1];
+                    acc[j] = SIMD_MM(mul_ps)(SIMD_MM(load_ps)(row), SIMD_MM(loadu_ps)(d));
+                    for (size_t v = 1; v < nVectors; ++v)
+                        acc[j] = SIMD_MM(add_ps)(acc[j],
+                                                 SIMD_MM(mul_ps)(SIMD_MM(load_ps)(row + 4 * v),
+                                                                 SIMD_MM(loadu_ps)(d + 4 * v)));
+                }
+                SIMD_MM(storeu_ps)(out + o, mechanics::hsum4_ps(acc[0], acc[1], acc[2], acc[3]));
+            }
+            memmove(&input[c][0], &input[c][inputSize], historySize * sizeof(float));
+        }
+    }
+};
 } // namespace sst::basic_blocks::dsp
 #endif
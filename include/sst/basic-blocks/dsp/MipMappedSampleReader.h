@@ -0,0 +1,169 @@
+/*
+ * sst-basic-blocks - an open source library of core audio utilities
+ * built by Surge Synth Team.
+ *
+ * Provides a collection of tools useful on the audio thread for blocks,
+ * modulation, etc... or useful for adapting code to multiple environments.
+ *
+ * Copyright 2023, various authors, as described in the GitHub
+ * transaction log. Parts of this code are derived from similar
+ * functions original in Surge or ShortCircuit.
+ *
+ * sst-basic-blocks is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html.
+ *
+ * A very small number of explicitly chosen header files can also be
+ * used in an MIT/BSD context. Please see the README.md file in this
+ * repo or the comments in the individual files. Only headers with an
+ * explicit mention that they are dual licensed may be copied and reused
+ * outside the GPL3 terms.
+ *
+ * All source in sst-basic-blocks available at
+ * https://github.com/surge-synthesizer/sst-basic-blocks
+ */
+
+#ifndef INCLUDE_SST_BASIC_BLOCKS_DSP_MIPMAPPEDSAMPLEREADER_H
+#define INCLUDE_SST_BASIC_BLOCKS_DSP_MIPMAPPEDSAMPLEREADER_H
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "sst/basic-blocks/tables/SincTableProvider.h"
+#include "sst/basic-blocks/dsp/SpecialFunctions.h"
+#include "sst/basic-blocks/dsp/SSESincDelayLine.h"
+
+namespace sst::basic_blocks::dsp
+{
+/*
+ * A sampler voice reader which stays band limited at any upward transposition. build makes
+ * a chain of half band filtered, decimated copies of a sample (level k is at 1 / 2^k of the
+ * original rate), each padded as SSESincInterpolater wants. A read at a playback ratio of
+ * r frames per output sample picks the levels either side of log2(r) and crossfades a sinc
+ * read of each, so a read always costs two sinc reads however far the sample is pitched.
+ *
+ * As with trilinear mip mapping the lower of the two levels can still alias a little near
+ * the top of its octave, under a small crossfade weight; a positive levelBias moves the
+ * choice up for cleaner but duller playback.
+ *
+ * Samples are interleaved with stride channels. build allocates, so call it off the audio
+ * thread; reads don't. The table provider has to outlive the reader.
+ */
+template <uint32_t stride = 1> struct MipMappedSampleReader
+{
+    using stp = tables::SurgeSincTableProvider;
+    using interp_t = SSESincInterpolater<stride>;
+
+    static constexpr int maxLevels{12};
+    static constexpr size_t padding{stp::FIRipol_N};
+    // the half band filter is 2 * halfBandHalfWidth + 1 taps long
+    static constexpr int halfBandHalfWidth{16};
+
+    float levelBias{0.f};
+
+    const stp &sincTables;
+    MipMappedSampleReader(const stp &st) : sincTables(st) {}
+
+    // the interpolators point into levels, so a copy would read the source's buffers; a move
+    // carries the level buffers along and so stays valid
+    MipMappedSampleReader(const MipMappedSampleReader &) = delete;
+    MipMappedSampleReader &operator=(const MipMappedSampleReader &) = delete;
+    MipMappedSampleReader(MipMappedSampleReader &&) = default;
+
+    /*
+     * Build up to nLevels levels from frames interleaved frames of data, stopping early if a
+     * level would be shorter than the sinc window.
+     */
+    void build(const float *data, size_t frames, int nLevels = maxLevels)
+    {
+        levels.clear();
+        interpolators.clear();
+        nLevels = std::clamp(nLevels, 1, maxLevels);
+
+        auto &l0 = levels.emplace_back(stride * (frames + 2 * padding), 0.f);
+        std::copy(data, data + stride * frames, l0.begin() + stride * padding);
+        levelFrames[0] = frames;
+
+        float hb[2 * halfBandHalfWidth + 1];
+        for (int i = 0; i < 2 * halfBandHalfWidth + 1; ++i)
+        {
+            hb[i] = 0.5 * sincf(0.5 * (i - halfBandHalfWidth)) *
+                    blackman(i, 2 * halfBandHalfWidth + 1);
+        }
+
+        for (int l = 1; l < nLevels; ++l)
+        {
+            auto srcFrames = levelFrames[l - 1];
+            auto dstFrames = (srcFrames + 1) / 2;
+            if (dstFrames < stp::FIRipol_N)
+                break;
+
+            auto &dst = levels.emplace_back(stride * (dstFrames + 2 * padding), 0.f);
+            const auto &src = levels[l - 1];
+            // zero phase, so level frame j sits on frame 2j of the level above
+            for (size_t j = 0; j < dstFrames; ++j)
+            {
+                for (uint32_t c = 0; c < stride; ++c)
+                {
+                    float acc{0.f};
+                    for (int k = -halfBandHalfWidth; k <= halfBandHalfWidth; ++k)
+                    {
+                        auto sf = (int64_t)(2 * j) + k;
+                        if (sf >= 0 && sf < (int64_t)srcFrames)
+                            acc += hb[k + halfBandHalfWidth] * src[stride * (sf + padding) + c];
+                    }
+                    dst[stride * (j + padding) + c] = acc;
+                }
+            }
+            levelFrames[l] = dstFrames;
+        }
+
+        // the level vectors don't move from here so the interpolators can point in
+        for (size_t l = 0; l < levels.size(); ++l)
+            interpolators.emplace_back(sincTables, levels[l].data(), levelFrames[l] + 2 * padding);
+    }
+
+    int numLevels() const { return (int)levels.size(); }
+    size_t framesAt(int level) const { return levelFrames[level]; }
+
+    /*
+     * All stride channels at frame posn of the original sample, for playback at ratio
+     * original frames per output sample, into out[0..stride).
+     */
+    inline void readAll(float posn, float ratio, float *out)
+    {
+        auto lvl = std::max(std::log2(std::max(ratio, 1e-6f)) + levelBias, 0.f);
+        auto lo = std::min((int)lvl, numLevels() - 1);
+        auto hi = std::min(lo + 1, numLevels() - 1);
+        auto mix = lo == hi ? 0.f : lvl - lo;
+
+        interpolators[lo].readAll(posn * levelScale(lo), out);
+        if (mix > 0.f)
+        {
+            float hiOut[stride];
+            interpolators[hi].readAll(posn * levelScale(hi), hiOut);
+            for (uint32_t c = 0; c < stride; ++c)
+                out[c] += mix * (hiOut[c] - out[c]);
+        }
+    }
+
+    inline float read(float posn, float ratio)
+    {
+        static_assert(stride == 1, "Use readAll for interleaved samples");
+        float res;
+        readAll(posn, ratio, &res);
+        return res;
+    }
+
+  protected:
+    static float levelScale(int level) { return 1.f / (float)(1 << level); }
+
+    std::vector<std::vector<float>> levels;
+    std::vector<interp_t> interpolators;
+    size_t levelFrames[maxLevels]{};
+};
+} // namespace sst::basic_blocks::dsp
+
+#endif // INCLUDE_SST_BASIC_BLOCKS_DSP_MIPMAPPEDSAMPLEREADER_H
@@ -28,7 +28,9 @@
 #define INCLUDE_SST_BASIC_BLOCKS_DSP_QUADRATUREOSCILLATORS_H
 
 #include "sst/basic-blocks/mechanics/block-ops.h"
+#include "FastMath.h"
 
+#include <algorithm>
 #include <cmath>
 
 namespace sst::basic_blocks::dsp
@@ -139,6 +141,198 @@ template <typename T = float> struct SurgeQuadrOsc
   private:
     T dr, di;
 };
+
+/**
+ * A bank of up to maxPartials Vicanek quadrature oscillators with per partial amplitude,
+ * four partials to a SIMD register, summed to one output, for additive voices. The update
+ * is three shears, which is an exact rotation when k2 = 2 k1 / (1 + k1^2), so we only
+ * approximate k1 = tan(omega/2) (with fasttanSSE) and derive k2 from it; that moves the
+ * pitch a hair but never the amplitude. Coefficients and amplitudes ramp linearly over
+ * each block, which is only approximately a rotation, so each block ends with a one step
+ * renormalization. Partials at or above nyquist are silenced.
+ *
+ * processBlockFM scales every partial's frequency by a per sample multiplier (audio rate
+ * FM of the whole voice), recomputing the coefficients each sample.
+ */
+template <int maxPartials, int blockSize = 32> struct QuadratureOscillatorBank
+{
+    static_assert(maxPartials % 4 == 0, "Partials come in fours");
+    static_assert(blockSize % 4 == 0, "Block size must be a multiple of 4");
+    static constexpr int nQuads{maxPartials / 4};
+
+    QuadratureOscillatorBank() { reset(); }
+
+    void reset()
+    {
+        for (int i = 0; i < maxPartials; ++i)
+        {
+            omega[i] = 0;
+            amplitude[i] = 0;
+        }
+        for (int q = 0; q < nQuads; ++q)
+        {
+            u[q] = SIMD_MM(set1_ps)(1.f);
+            v[q] = SIMD_MM(setzero_ps)();
+            k1[q] = SIMD_MM(setzero_ps)();
+            amp[q] = SIMD_MM(setzero_ps)();
+        }
+        snapToTargets = true;
+    }
+
+    /*
+     * Only the first n partials (rounded up to a multiple of 4) are rendered.
+     */
+    void setActivePartials(int n) { activeQuads = std::clamp((n + 3) / 4, 0, nQuads); }
+
+    void setPartial(int i, float omegaInRadiansPerSample, float amplitudeOfPartial)
+    {
+        omega[i] = omegaInRadiansPerSample;
+        amplitude[i] = amplitudeOfPartial;
+    }
+
+    // the phase of a partial, where 0 starts it as a sine
+    void setPhase(int i, float phase)
+    {
+        float uf alignas(16)[4], vf alignas(16)[4];
+        SIMD_MM(store_ps)(uf, u[i / 4]);
+        SIMD_MM(store_ps)(vf, v[i / 4]);
+        uf[i % 4] = std::cos(phase);
+        vf[i % 4] = std::sin(phase);
+        u[i / 4] = SIMD_MM(load_ps)(uf);
+        v[i / 4] = SIMD_MM(load_ps)(vf);
+    }
+
+    void processBlock(float *out)
+    {
+        SIMD_M128 acc[blockSize];
+        const auto bsInv = SIMD_MM(set1_ps)(1.f / blockSize);
+
+        for (int q = 0; q < activeQuads; ++q)
+        {
+            SIMD_M128 below;
+            auto tk1 = k1For(q, SIMD_MM(set1_ps)(1.f), below);
+            auto tamp = SIMD_MM(and_ps)(SIMD_MM(loadu_ps)(amplitude + q * 4), below);
+            if (snapToTargets)
+            {
+                k1[q] = tk1;
+                amp[q] = tamp;
+            }
+            auto ck1 = k1[q], ck2 = k2From(ck1), ca = amp[q];
+            auto dk1 = SIMD_MM(mul_ps)(SIMD_MM(sub_ps)(tk1, ck1), bsInv);
+            auto dk2 = SIMD_MM(mul_ps)(SIMD_MM(sub_ps)(k2From(tk1), ck2), bsInv);
+            auto da = SIMD_MM(mul_ps)(SIMD_MM(sub_ps)(tamp, ca), bsInv);
+
+            auto cu = u[q], cv = v[q];
+            for (int s = 0; s < blockSize; ++s)
+            {
+                rotate(cu, cv, ck1, ck2);
+                auto o = SIMD_MM(mul_ps)(cv, ca);
+                acc[s] = q == 0 ? o : SIMD_MM(add_ps)(acc[s], o);
+
+                ck1 = SIMD_MM(add_ps)(ck1, dk1);
+                ck2 = SIMD_MM(add_ps)(ck2, dk2);
+                ca = SIMD_MM(add_ps)(ca, da);
+            }
+            renormalize(cu, cv);
+            u[q] = cu;
+            v[q] = cv;
+            k1[q] = tk1;
+            amp[q] = tamp;
+        }
+        snapToTargets = false;
+        sumLanes(acc, out);
+    }
+
+    void processBlockFM(const float *omegaMultiplier, float *out)
+    {
+        SIMD_M128 acc[blockSize];
+        const auto bsInv = SIMD_MM(set1_ps)(1.f / blockSize);
+
+        for (int q = 0; q < activeQuads; ++q)
+        {
+            auto tamp = SIMD_MM(loadu_ps)(amplitude + q * 4);
+            if (snapToTargets)
+                amp[q] = tamp;
+            auto ca = amp[q];
+            auto da = SIMD_MM(mul_ps)(SIMD_MM(sub_ps)(tamp, ca), bsInv);
+
+            auto cu = u[q], cv = v[q];
+            SIMD_M128 ck1, below;
+            for (int s = 0; s < blockSize; ++s)
+            {
+                ck1 = k1For(q, SIMD_MM(set1_ps)(omegaMultiplier[s]), below);
+                rotate(cu, cv, ck1, k2From(ck1));
+                auto o = SIMD_MM(and_ps)(SIMD_MM(mul_ps)(cv, ca), below);
+                acc[s] = q == 0 ? o : SIMD_MM(add_ps)(acc[s], o);
+                ca = SIMD_MM(add_ps)(ca, da);
+            }
+            renormalize(cu, cv);
+            u[q] = cu;
+            v[q] = cv;
+            k1[q] = ck1;
+            amp[q] = tamp;
+        }
+        snapToTargets = false;
+        sumLanes(acc, out);
+    }
+
+    float omega[maxPartials], amplitude[maxPartials];
+
+  protected:
+    // k1 for omega * mul, with below set where that is under nyquist (and k1 0 where not)
+    SIMD_M128 k1For(int q, SIMD_M128 mul, SIMD_M128 &below)
+    {
+        static constexpr float maxOmega{3.1f};
+        auto w = SIMD_MM(mul_ps)(SIMD_MM(loadu_ps)(omega + q * 4), mul);
+        auto aw = SIMD_MM(andnot_ps)(SIMD_MM(set1_ps)(-0.f), w);
+        below = SIMD_MM(cmplt_ps)(aw, SIMD_MM(set1_ps)(maxOmega));
+        w = SIMD_MM(and_ps)(w, below);
+        return fasttanSSE(SIMD_MM(mul_ps)(w, SIMD_MM(set1_ps)(0.5f)));
+    }
+
+    static SIMD_M128 k2From(SIMD_M128 k1)
+    {
+        auto one = SIMD_MM(set1_ps)(1.f);
+        return SIMD_MM(div_ps)(SIMD_MM(add_ps)(k1, k1),
+                               SIMD_MM(add_ps)(one, SIMD_MM(mul_ps)(k1, k1)));
+    }
+
+    static void rotate(SIMD_M128 &cu, SIMD_M128 &cv, SIMD_M128 ck1, SIMD_M128 ck2)
+    {
+        auto w = SIMD_MM(sub_ps)(cu, SIMD_MM(mul_ps)(ck1, cv));
+        cv = SIMD_MM(add_ps)(cv, SIMD_MM(mul_ps)(ck2, w));
+        cu = SIMD_MM(sub_ps)(w, SIMD_MM(mul_ps)(ck1, cv));
+    }
+
+    // one newton step towards u^2 + v^2 = 1, plenty for the drift of a block
+    static void renormalize(SIMD_M128 &cu, SIMD_M128 &cv)
+    {
+        auto r2 = SIMD_MM(add_ps)(SIMD_MM(mul_ps)(cu, cu), SIMD_MM(mul_ps)(cv, cv));
+        auto g = SIMD_MM(mul_ps)(SIMD_MM(sub_ps)(SIMD_MM(set1_ps)(3.f), r2),
+                                 SIMD_MM(set1_ps)(0.5f));
+        cu = SIMD_MM(mul_ps)(cu, g);
+        cv = SIMD_MM(mul_ps)(cv, g);
+    }
+
+    void sumLanes(SIMD_M128 *acc, float *out)
+    {
+        if (activeQuads == 0)
+        {
+            std::fill(out, out + blockSize, 0.f);
+            return;
+        }
+        for (int s = 0; s < blockSize; s += 4)
+        {
+            auto r = SIMD_MM(hadd_ps)(SIMD_MM(hadd_ps)(acc[s], acc[s + 1]),
+                                      SIMD_MM(hadd_ps)(acc[s + 2], acc[s + 3]));
+            SIMD_MM(storeu_ps)(out + s, r);
+        }
+    }
+
+    SIMD_M128 u[nQuads], v[nQuads], k1[nQuads], amp[nQuads];
+    int activeQuads{nQuads};
+    bool snapToTargets{true};
+};
 } // namespace sst::basic_blocks::dsp
 
 #endif // SHORTCIRCUITXT_QUADRATUREOSCILLATORS_H
@@ -31,7 +31,12 @@
 #include "sst/basic-blocks/mechanics/simd-ops.h"
 #include "sst/basic-blocks/tables/SincTableProvider.h"
 #include "sst/basic-blocks/dsp/Interpolators.h"
+#if defined(SST_SIMD_NATIVE_X86) && defined(__AVX2__)
+#include <immintrin.h>
+#endif
 #include <array>
+#include <cstring>
+#include <algorithm>
 
 namespace sst::basic_blocks::dsp
 {
@@ -101,6 +106,81 @@ struct SSESincDelayLine
         return res;
     }
 
+    /*
+     * Four sinc taps at once, one for each lane of delay, as read(float) would return them.
+     * The table offsets and read pointers are computed for all four lanes together and the
+     * four dot products are reduced with one transpose and add rather than a horizontal
+     * sum each.
+     */
+    inline SIMD_M128 read(SIMD_M128 delay) { return readAt(SIMD_MM(set1_epi32)(wp), delay); }
+
+    // As read(SIMD_M128), but lane i reads as if the write pointer were wps[i]
+    inline SIMD_M128 readAt(SIMD_M128I wps, SIMD_M128 delay)
+    {
+        auto iDelay = SIMD_MM(cvttps_epi32)(delay);
+        auto fracDelay = SIMD_MM(sub_ps)(delay, SIMD_MM(cvtepi32_ps)(iDelay));
+        auto tIdx = SIMD_MM(cvttps_epi32)(SIMD_MM(mul_ps)(
+            SIMD_MM(sub_ps)(SIMD_MM(set1_ps)(1.f), fracDelay), SIMD_MM(set1_ps)(stp::FIRipol_M)));
+        auto rp = SIMD_MM(and_si128)(
+            SIMD_MM(sub_epi32)(
+                SIMD_MM(sub_epi32)(wps, SIMD_MM(set1_epi32)(stp::FIRipol_N >> 1)), iDelay),
+            SIMD_MM(set1_epi32)(COMB_SIZE - 1));
+
+        int sincTableOffset alignas(16)[4], readPtr alignas(16)[4];
+        SIMD_MM(store_si128)((SIMD_M128I *)sincTableOffset, tIdx);
+        SIMD_MM(store_si128)((SIMD_M128I *)readPtr, rp);
+
+        SIMD_M128 o[4];
+        for (int i = 0; i < 4; ++i)
+        {
+            const auto *bf = &buffer[readPtr[i]];
+            const auto *st = &sinctable[sincTableOffset[i] * stp::FIRipol_N * 2];
+            o[i] = SIMD_MM(mul_ps)(SIMD_MM(loadu_ps)(bf), SIMD_MM(loadu_ps)(st));
+            o[i] = SIMD_MM(add_ps)(
+                o[i], SIMD_MM(mul_ps)(SIMD_MM(loadu_ps)(bf + 4), SIMD_MM(loadu_ps)(st + 4)));
+            o[i] = SIMD_MM(add_ps)(
+                o[i], SIMD_MM(mul_ps)(SIMD_MM(loadu_ps)(bf + 8), SIMD_MM(loadu_ps)(st + 8)));
+        }
+        return sst::basic_blocks::mechanics::hsum4_ps(o[0], o[1], o[2], o[3]);
+    }
+
+    // n taps into out, four at a time through read(SIMD_M128)
+    inline void readN(const float *delays, float *out, int n)
+    {
+        int i = 0;
+        for (; i + 4 <= n; i += 4)
+            SIMD_MM(storeu_ps)(out + i, read(SIMD_MM(loadu_ps)(delays + i)));
+        for (; i < n; ++i)
+            out[i] = read(delays[i]);
+    }
+
+    /*
+     * A modulated delay over a block: for each sample write in[i] then out[i] is the sinc
+     * read at delay[i]. Samples are written four at a time and those four are then read
+     * together through readAt, each lane with the write pointer its sample would have seen,
+     * so the table offset and pointer math is vectorized across samples. That is the same as
+     * the per sample write and read as long as delays are at least FIRipol_N / 2, which a
+     * sinc read needs to stay causal anyway. in and out may alias.
+     *
+     * Since up to three later samples are already written when a lane reads, the longest
+     * usable delay is three samples shorter than for read(float), about
+     * COMB_SIZE - FIRipol_N - 3, independent of BS.
+     */
+    template <int BS> inline void process(const float *in, const float *delay, float *out)
+    {
+        static_assert(BS % 4 == 0, "Block size must be a multiple of 4");
+
+        auto wps = SIMD_MM(add_epi32)(SIMD_MM(set1_epi32)(wp), SIMD_MM(setr_epi32)(1, 2, 3, 4));
+        const auto four = SIMD_MM(set1_epi32)(4);
+        for (int i = 0; i < BS; i += 4)
+        {
+            for (int j = 0; j < 4; ++j)
+                write(in[i + j]);
+            SIMD_MM(storeu_ps)(out + i, readAt(wps, SIMD_MM(loadu_ps)(delay + i)));
+            wps = SIMD_MM(add_epi32)(wps, four);
+        }
+    }
+
     inline float readLinear(float delay)
     {
         auto iDelay = (int)delay;
@@ -144,19 +224,29 @@ struct SSESincDelayLine
     }
 };
 
-#define ADD(a, b) SIMD_MM(add_ps)(a, b)
-#define SUB(a, b) SIMD_MM(sub_epi32)(a, b)
-#define MUL(a, b) SIMD_MM(mul_ps)(a, b)
-
-// Similar to the above, but writes and reads four delay lines in parallel using SSE intrinsics
-// Linear interpolation only for now
-template <int COMB_SIZE> struct quadDelayLine
+/*
+ * Similar to the above, but writes and reads four delay lines in parallel, one per SIMD lane.
+ * The lines share one buffer staggered by lineSize, so each can delay by up to lineSize.
+ *
+ * Reads come in linear, cubic and (given a SurgeSincTableProvider) 12 tap sinc flavors with
+ * the same delay conventions as SSESincDelayLine. Single sample reads are gathered with the
+ * AVX2 gather where the build targets it and with scalar loads otherwise; hardwareGather =
+ * false forces the scalar loads, mostly so the two can be compared.
+ */
+template <int COMB_SIZE, bool hardwareGather = true> struct quadDelayLine
 {
     static_assert(!(COMB_SIZE & (COMB_SIZE - 1))); // make sure we are a power of 2
 
-    float buffer alignas(16)[COMB_SIZE];
+    using stp = tables::SurgeSincTableProvider;
+
+    // the first FIRipol_N samples are mirrored past the end so sinc reads never wrap
+    float buffer alignas(16)[COMB_SIZE + stp::FIRipol_N];
+    const float *sinctable{nullptr};
 
     quadDelayLine() { clear(); }
+    quadDelayLine(const float *st) : sinctable(st) { clear(); }
+    // As with SSESincDelayLine, the provider has to outlive this line
+    quadDelayLine(const tables::SurgeSincTableProvider &st) : sinctable(st.sinctable) { clear(); }
 
     static constexpr int lineSize{COMB_SIZE / 4};
     SIMD_M128I lineOffsets = SIMD_MM(set_epi32)(lineSize * 3, lineSize * 2, lineSize, 0);
@@ -168,32 +258,44 @@ template <int COMB_SIZE> struct quadDelayLine
     const SIMD_M128I ZERO = SIMD_MM(setzero_si128)();
     const SIMD_M128 ONEF = SIMD_MM(set1_ps)(1.f);
 
+#if defined(SST_SIMD_NATIVE_X86) && defined(__AVX2__)
+    static constexpr bool usesHardwareGather{hardwareGather};
+#else
+    static constexpr bool usesHardwareGather{false};
+#endif
+
+    // buffer[idx[i]] for each lane
+    inline SIMD_M128 gather(SIMD_M128I idx) const
+    {
+#if defined(SST_SIMD_NATIVE_X86) && defined(__AVX2__)
+        if constexpr (usesHardwareGather)
+            return _mm_i32gather_ps(buffer, idx, sizeof(float));
+#endif
+        int i alignas(16)[4];
+        SIMD_MM(store_si128)((SIMD_M128I *)i, idx);
+        return SIMD_MM(setr_ps)(buffer[i[0]], buffer[i[1]], buffer[i[2]], buffer[i[3]]);
+    }
+
     void write(SIMD_M128 val)
     {
-        // so the idea is buffer[wp[i]] = toLines[i];
-        // I wonder which of these will be fastest?
-        // option one:
+        // There is no scatter before AVX-512, so this is buffer[wp[i]] = val[i] by hand,
+        // but from stored indices rather than an extract per lane.
         float toLines alignas(16)[4];
+        int wp alignas(16)[4];
         SIMD_MM(store_ps)(toLines, val);
+        SIMD_MM(store_si128)((SIMD_M128I *)wp, wpSSE);
 
-        buffer[SIMD_MM(extract_epi32)(wpSSE, 0)] = toLines[0];
-        buffer[SIMD_MM(extract_epi32)(wpSSE, 1)] = toLines[1];
-        buffer[SIMD_MM(extract_epi32)(wpSSE, 2)] = toLines[2];
-        buffer[SIMD_MM(extract_epi32)(wpSSE, 3)] = toLines[3];
-
-        // option two (that shuffle macros doesn't work but...):
-        // buffer[SIMD_MM(extract_epi32)(wpSSE, 3)] = SIMD_MM(cvtss_f32)(val);
-        // buffer[SIMD_MM(extract_epi32)(wpSSE, 2)] = SIMD_MM(cvtss_f32)(SHUFFLE(val, 1));
-        // buffer[SIMD_MM(extract_epi32)(wpSSE, 1)] = SIMD_MM(cvtss_f32)(SHUFFLE(val, 2));
-        // buffer[SIMD_MM(extract_epi32)(wpSSE, 0)] = SIMD_MM(cvtss_f32)(SHUFFLE(val, 3));
-        // TODO: Investigate that
-        // I woulda done it already but all the macros and stuff
-        // makes it annoying to get into godbolt
+        for (int i = 0; i < 4; ++i)
+        {
+            buffer[wp[i]] = toLines[i];
+            buffer[wp[i] + (wp[i] < stp::FIRipol_N) * COMB_SIZE] = toLines[i];
+        }
 
         // wp = (wp + 1) & (lineSize - 1);
         wpSSE = SIMD_MM(and_si128)(SIMD_MM(add_epi32)(wpSSE, ONE), combMaskSSE);
     }
 
+    // Linear interpolation; the same convention as SSESincDelayLine::readLinear
     SIMD_M128 read(SIMD_M128 delay)
     {
         // int iPosn = (int)posn;
@@ -201,34 +303,76 @@ template <int COMB_SIZE> struct quadDelayLine
         // float frac = posn - iPosn;
         auto frac = SIMD_MM(sub_ps)(delay, SIMD_MM(cvtepi32_ps)(ip));
         // int RP = (wp - iDelay) & (COMB_SIZE - 1);
-        auto RP = SIMD_MM(and_si128)(SUB(wpSSE, ip), combMaskSSE);
-        // int RPP = RP == 0 ? COMB_SIZE - 1 : RP - 1;
-        // sorry about all the casts lol, sadly there's no blendv_epi32 *shrug emoji*
-        auto RPP = SIMD_MM(castps_si128)(SIMD_MM(blendv_ps)(
-            SIMD_MM(castsi128_ps)(SUB(RP, ONE)), SIMD_MM(castsi128_ps)(SUB(combMaskSSE, ONE)),
-            SIMD_MM(castsi128_ps)(SIMD_MM(cmpeq_epi32)(RP, ZERO))));
-
-        // read from the lines and load into fresh registers
-        auto bufRP = SIMD_MM(set_ps)(
-            buffer[SIMD_MM(extract_epi32)(RP, 3)], buffer[SIMD_MM(extract_epi32)(RP, 2)],
-            buffer[SIMD_MM(extract_epi32)(RP, 1)], buffer[SIMD_MM(extract_epi32)(RP, 0)]);
-        auto bufRPP = SIMD_MM(set_ps)(
-            buffer[SIMD_MM(extract_epi32)(RPP, 3)], buffer[SIMD_MM(extract_epi32)(RPP, 2)],
-            buffer[SIMD_MM(extract_epi32)(RPP, 1)], buffer[SIMD_MM(extract_epi32)(RPP, 0)]);
+        auto RP = SIMD_MM(and_si128)(SIMD_MM(sub_epi32)(wpSSE, ip), combMaskSSE);
+        // int RPP = (RP - 1) & (COMB_SIZE - 1);
+        auto RPP = SIMD_MM(and_si128)(SIMD_MM(sub_epi32)(RP, ONE), combMaskSSE);
+
+        auto bufRP = gather(RP);
+        auto bufRPP = gather(RPP);
 
         // return buffer[RP] * (1 - frac) + buffer[RPP] * frac;
-        return ADD(MUL(bufRP, SIMD_MM(sub_ps)(ONEF, frac)), MUL(bufRPP, frac));
+        return SIMD_MM(add_ps)(SIMD_MM(mul_ps)(bufRP, SIMD_MM(sub_ps)(ONEF, frac)),
+                               SIMD_MM(mul_ps)(bufRPP, frac));
+    }
+
+    // Cubic (4-tap Hermite); the same convention as SSESincDelayLine::readCubic
+    SIMD_M128 readCubic(SIMD_M128 delay)
+    {
+        auto ip = SIMD_MM(cvttps_epi32)(delay);
+        auto mu = SIMD_MM(sub_ps)(delay, SIMD_MM(cvtepi32_ps)(ip));
+        auto RP = SIMD_MM(and_si128)(SIMD_MM(sub_epi32)(wpSSE, ip), combMaskSSE);
+
+        auto y0 = gather(SIMD_MM(and_si128)(SIMD_MM(add_epi32)(RP, ONE), combMaskSSE));
+        auto y1 = gather(RP);
+        auto y2 = gather(SIMD_MM(and_si128)(SIMD_MM(sub_epi32)(RP, ONE), combMaskSSE));
+        auto y3 = gather(
+            SIMD_MM(and_si128)(SIMD_MM(sub_epi32)(RP, SIMD_MM(set1_epi32)(2)), combMaskSSE));
+
+        // cubic_ipol, lane-wise
+        auto a0 = SIMD_MM(add_ps)(SIMD_MM(sub_ps)(SIMD_MM(sub_ps)(y3, y2), y0), y1);
+        auto a1 = SIMD_MM(sub_ps)(SIMD_MM(sub_ps)(y0, y1), a0);
+        auto a2 = SIMD_MM(sub_ps)(y2, y0);
+        auto r = SIMD_MM(add_ps)(SIMD_MM(mul_ps)(a0, mu), a1);
+        r = SIMD_MM(add_ps)(SIMD_MM(mul_ps)(r, mu), a2);
+        return SIMD_MM(add_ps)(SIMD_MM(mul_ps)(r, mu), y1);
+    }
+
+    // 12 tap sinc; the same convention as SSESincDelayLine::read. Needs a sinctable.
+    SIMD_M128 readSinc(SIMD_M128 delay)
+    {
+        auto ip = SIMD_MM(cvttps_epi32)(delay);
+        auto frac = SIMD_MM(sub_ps)(delay, SIMD_MM(cvtepi32_ps)(ip));
+        auto tIdx = SIMD_MM(cvttps_epi32)(
+            SIMD_MM(mul_ps)(SIMD_MM(sub_ps)(ONEF, frac), SIMD_MM(set1_ps)(stp::FIRipol_M)));
+        auto rp = SIMD_MM(and_si128)(
+            SIMD_MM(sub_epi32)(
+                SIMD_MM(sub_epi32)(wpSSE, ip), SIMD_MM(set1_epi32)(stp::FIRipol_N >> 1)),
+            combMaskSSE);
+
+        int sincTableOffset alignas(16)[4], readPtr alignas(16)[4];
+        SIMD_MM(store_si128)((SIMD_M128I *)sincTableOffset, tIdx);
+        SIMD_MM(store_si128)((SIMD_M128I *)readPtr, rp);
+
+        SIMD_M128 o[4];
+        for (int i = 0; i < 4; ++i)
+        {
+            const auto *bf = &buffer[readPtr[i]];
+            const auto *st = &sinctable[sincTableOffset[i] * stp::FIRipol_N * 2];
+            o[i] = SIMD_MM(mul_ps)(SIMD_MM(loadu_ps)(bf), SIMD_MM(loadu_ps)(st));
+            o[i] = SIMD_MM(add_ps)(
+                o[i], SIMD_MM(mul_ps)(SIMD_MM(loadu_ps)(bf + 4), SIMD_MM(loadu_ps)(st + 4)));
+            o[i] = SIMD_MM(add_ps)(
+                o[i], SIMD_MM(mul_ps)(SIMD_MM(loadu_ps)(bf + 8), SIMD_MM(loadu_ps)(st + 8)));
+        }
+        return sst::basic_blocks::mechanics::hsum4_ps(o[0], o[1], o[2], o[3]);
     }
 
     inline void clear()
     {
-        memset((void *)buffer, 0, COMB_SIZE * sizeof(float));
+        memset((void *)buffer, 0, (COMB_SIZE + stp::FIRipol_N) * sizeof(float));
         wpSSE = lineOffsets;
     }
 };
-#undef ADD
-#undef SUB
-#undef MUL
 
 /*
  * This is a class which encapsulates the SSE based SINC
@@ -319,6 +463,84 @@ template <uint32_t stride> struct SSESincInterpolater
         return res;
     }
 
+    /*
+     * Every channel of interleaved data at posn at once, out[c] for c < stride, each the
+     * same as read on data + c. The interleaved frames are loaded contiguously and the
+     * taps spread across them in registers, rather than gathered a channel at a time: for
+     * stereo each load is two frames against a pair of duplicated taps, and for multiples
+     * of four channels each load is a group of channels against a broadcast tap. Other
+     * strides fall back to a strided read per channel.
+     */
+    inline void readAll(float posn, float *out)
+    {
+        auto iPosn = (size_t)posn;
+        auto fracPosn = posn - iPosn;
+        auto sincTableOffset = (int)(fracPosn * stp::FIRipol_M) * stp::FIRipol_N * 2;
+        int readPtr = stride * (iPosn + (offset + 1) - (stp::FIRipol_N >> 1));
+
+        const auto *d = &data[readPtr];
+        const auto *st = &sinctable[sincTableOffset];
+
+        if constexpr (stride == 1)
+        {
+            out[0] = read(posn);
+        }
+        else if constexpr (stride == 2)
+        {
+            // lanes are L R L R of an even then odd frame
+            auto acc = SIMD_MM(setzero_ps)();
+            for (int k = 0; k < stp::FIRipol_N; k += 4)
+            {
+                auto c = SIMD_MM(loadu_ps)(st + k);
+                auto lo = SIMD_MM(unpacklo_ps)(c, c);
+                auto hi = SIMD_MM(unpackhi_ps)(c, c);
+                acc = SIMD_MM(add_ps)(acc, SIMD_MM(mul_ps)(SIMD_MM(loadu_ps)(d + 2 * k), lo));
+                acc = SIMD_MM(add_ps)(acc, SIMD_MM(mul_ps)(SIMD_MM(loadu_ps)(d + 2 * k + 4), hi));
+            }
+            acc = SIMD_MM(add_ps)(acc, SIMD_MM(movehl_ps)(acc, acc));
+            float res alignas(16)[4];
+            SIMD_MM(store_ps)(res, acc);
+            out[0] = res[0];
+            out[1] = res[1];
+        }
+        else if constexpr (stride % 4 == 0)
+        {
+            static constexpr int nGroups = stride / 4;
+            SIMD_M128 acc[nGroups];
+            for (int g = 0; g < nGroups; ++g)
+                acc[g] = SIMD_MM(setzero_ps)();
+            for (int k = 0; k < stp::FIRipol_N; k += 4)
+            {
+                auto c = SIMD_MM(loadu_ps)(st + k);
+                SIMD_M128 ck[4]{SIMD_MM(shuffle_ps)(c, c, SIMD_MM_SHUFFLE(0, 0, 0, 0)),
+                                SIMD_MM(shuffle_ps)(c, c, SIMD_MM_SHUFFLE(1, 1, 1, 1)),
+                                SIMD_MM(shuffle_ps)(c, c, SIMD_MM_SHUFFLE(2, 2, 2, 2)),
+                                SIMD_MM(shuffle_ps)(c, c, SIMD_MM_SHUFFLE(3, 3, 3, 3))};
+                for (int j = 0; j < 4; ++j)
+                {
+                    const auto *fr = d + (k + j) * stride;
+                    for (int g = 0; g < nGroups; ++g)
+                        acc[g] = SIMD_MM(add_ps)(
+                            acc[g], SIMD_MM(mul_ps)(SIMD_MM(loadu_ps)(fr + 4 * g), ck[j]));
+                }
+            }
+            for (int g = 0; g < nGroups; ++g)
+                SIMD_MM(storeu_ps)(out + 4 * g, acc[g]);
+        }
+        else
+        {
+            for (uint32_t c = 0; c < stride; ++c)
+            {
+                auto o = SIMD_MM(mul_ps)(pop4(readPtr + c), SIMD_MM(loadu_ps)(st));
+                o = SIMD_MM(add_ps)(
+                    o, SIMD_MM(mul_ps)(pop4(readPtr + c + 4 * stride), SIMD_MM(loadu_ps)(st + 4)));
+                o = SIMD_MM(add_ps)(
+                    o, SIMD_MM(mul_ps)(pop4(readPtr + c + 8 * stride), SIMD_MM(loadu_ps)(st + 8)));
+                SIMD_MM(store_ss)(&out[c], sst::basic_blocks::mechanics::sum_ps_to_ss(o));
+            }
+        }
+    }
+
     inline float readLinear(float posn)
     {
         auto iPosn = (int)posn;
@@ -27,6 +27,7 @@
 #ifndef INCLUDE_SST_BASIC_BLOCKS_DSP_SMOOTHINGSTRATEGIES_H
 #define INCLUDE_SST_BASIC_BLOCKS_DSP_SMOOTHINGSTRATEGIES_H
 
+#include <cmath>
 #include "Lag.h"
 #include "BlockInterpolators.h"
 
@@ -45,6 +46,20 @@ struct LagSmoothingStrategy
     static double getValue(smoothValue_t &v) { return v.v; }
     static void process(smoothValue_t &v) { v.process(); }
 
+    /*
+     * True if process will not move the value, so a caller can skip it for a block. The
+     * lag only approaches its target, so once within a hair of it we snap there.
+     */
+    static bool settle(smoothValue_t &v)
+    {
+        if (v.v == v.target_v)
+            return true;
+        if (std::fabs(v.v - v.target_v) > 1e-9 * std::fabs(v.target_v))
+            return false;
+        v.v = v.target_v;
+        return true;
+    }
+
     static void resetFirstRun(smoothValue_t &v) { v.first_run = true; }
 };
 template <int blockSize> struct BlockInterpSmoothingStrategy
@@ -58,6 +73,7 @@ template <int blockSize> struct BlockInterpSmoothingStrategy
     }
     static double getValue(smoothValue_t &v) { return v.v; }
     static void process(smoothValue_t &v) { v.process(); }
+    static bool settle(smoothValue_t &v) { return v.dv == 0; }
     static void resetFirstRun(smoothValue_t &v) { v.first_run = true; }
 };
 struct NoSmoothingStrategy
@@ -67,6 +83,7 @@ struct NoSmoothingStrategy
     static void setValueInstant(smoothValue_t &v, float t) { v = t; }
     static double getValue(smoothValue_t &v) { return v; }
     static void process(smoothValue_t &v) {}
+    static bool settle(smoothValue_t &v) { return true; }
 
     static void resetFirstRun(smoothValue_t &v) {}
 };
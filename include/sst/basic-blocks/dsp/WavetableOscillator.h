@@ -0,0 +1,361 @@
+/*
+ * sst-basic-blocks - an open source library of core audio utilities
+ * built by Surge Synth Team.
+ *
+ * Provides a collection of tools useful on the audio thread for blocks,
+ * modulation, etc... or useful for adapting code to multiple environments.
+ *
+ * Copyright 2023, various authors, as described in the GitHub
+ * transaction log. Parts of this code are derived from similar
+ * functions original in Surge or ShortCircuit.
+ *
+ * sst-basic-blocks is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html.
+ *
+ * A very small number of explicitly chosen header files can also be
+ * used in an MIT/BSD context. Please see the README.md file in this
+ * repo or the comments in the individual files. Only headers with an
+ * explicit mention that they are dual licensed may be copied and reused
+ * outside the GPL3 terms.
+ *
+ * All source in sst-basic-blocks available at
+ * https://github.com/surge-synthesizer/sst-basic-blocks
+ */
+
+#ifndef INCLUDE_SST_BASIC_BLOCKS_DSP_WAVETABLEOSCILLATOR_H
+#define INCLUDE_SST_BASIC_BLOCKS_DSP_WAVETABLEOSCILLATOR_H
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "sst/basic-blocks/simd/setup.h"
+
+namespace sst::basic_blocks::dsp
+{
+/*
+ * A set of single cycle frames and their band limited mip levels. Level l keeps harmonics
+ * up to frameSize / 2^(l+1) and is stored four times oversampled for that (so level 0 is
+ * 2 * frameSize long and each level after is half the one before), about four frames of
+ * memory per frame. The levels come from one DFT of each frame and a partial inverse per
+ * level, so building costs about 3 frameSize^2 multiply adds a frame: build off the audio
+ * thread, once, and share the result (see WavetableCache). Each level's frame carries one
+ * sample of wrap before and two after so the cubic reads never wrap.
+ */
+struct Wavetable
+{
+    static constexpr int maxLevels{16};
+    static constexpr int minLevelSize{16};
+    static constexpr int padBefore{1}, padAfter{2};
+
+    int frameSize{0}, nFrames{0}, nLevels{0};
+    int levelBits[maxLevels]{};
+
+    int levelSize(int l) const { return 1 << levelBits[l]; }
+    int harmonicsAt(int l) const { return std::max(frameSize >> (l + 1), 1); }
+    // frame(l, f)[i] for -1 <= i < levelSize(l) + 2
+    const float *frame(int l, int f) const
+    {
+        return levels[l].data() + (size_t)f * (levelSize(l) + padBefore + padAfter) + padBefore;
+    }
+
+    /*
+     * frames holds nFrames frames of frameSize samples; frameSize is a power of two.
+     */
+    static std::shared_ptr<const Wavetable> build(const float *frames, int frameSize,
+                                                  int nFrames)
+    {
+        assert(frameSize >= minLevelSize && (frameSize & (frameSize - 1)) == 0);
+        assert(nFrames > 0);
+
+        auto res = std::make_shared<Wavetable>();
+        res->frameSize = frameSize;
+        res->nFrames = nFrames;
+
+        int fBits{0};
+        while ((1 << fBits) < frameSize)
+            fBits++;
+
+        // level l's harmonic count halves each step until it is just the fundamental
+        for (int l = 0; l < maxLevels; ++l)
+        {
+            res->levelBits[l] = std::max(fBits + 1 - l, 4);
+            res->nLevels = l + 1;
+            if (res->harmonicsAt(l) <= 1)
+                break;
+        }
+        for (int l = 0; l < res->nLevels; ++l)
+            res->levels[l].resize((size_t)nFrames * (res->levelSize(l) + padBefore + padAfter));
+
+        // twiddles for the largest level; the frame and smaller levels stride through them
+        auto tSize = res->levelSize(0), tMask = tSize - 1;
+        std::vector<float> cs(tSize), sn(tSize);
+        for (int i = 0; i < tSize; ++i)
+        {
+            cs[i] = (float)std::cos(2.0 * M_PI * i / tSize);
+            sn[i] = (float)std::sin(2.0 * M_PI * i / tSize);
+        }
+
+        auto nH = frameSize / 2;
+        auto fStep = tSize / frameSize;
+        std::vector<double> re(nH), im(nH);
+        for (int f = 0; f < nFrames; ++f)
+        {
+            const auto *src = frames + (size_t)f * frameSize;
+            double dc{0};
+            for (int i = 0; i < frameSize; ++i)
+                dc += src[i];
+            dc /= frameSize;
+            // the nyquist bin is ambiguous, so we never keep it
+            for (int h = 1; h < nH; ++h)
+            {
+                double r{0}, m{0};
+                for (int i = 0, idx = 0; i < frameSize; ++i, idx = (idx + h * fStep) & tMask)
+                {
+                    r += src[i] * cs[idx];
+                    m += src[i] * sn[idx];
+                }
+                re[h] = 2 * r / frameSize;
+                im[h] = 2 * m / frameSize;
+            }
+
+            for (int l = 0; l < res->nLevels; ++l)
+            {
+                auto sz = res->levelSize(l);
+                auto step = tSize / sz;
+                auto hMax = std::min(res->harmonicsAt(l), nH - 1);
+                auto *dst = const_cast<float *>(res->frame(l, f));
+                for (int i = 0; i < sz; ++i)
+                {
+                    double v{dc};
+                    for (int h = 1, idx = i * step; h <= hMax; ++h, idx = (idx + i * step) & tMask)
+                        v += re[h] * cs[idx] + im[h] * sn[idx];
+                    dst[i] = (float)v;
+                }
+                dst[-1] = dst[sz - 1];
+                dst[sz] = dst[0];
+                dst[sz + 1] = dst[1];
+            }
+        }
+        return res;
+    }
+
+  protected:
+    std::vector<float> levels[maxLevels];
+};
+
+/*
+ * Shares built wavetables between voices, keyed on the frame data, so 128 voices playing
+ * the same table hold one copy. The cache only keeps weak references, so a table goes away
+ * with the last voice using it. get may build, so call it off the audio thread.
+ */
+struct WavetableCache
+{
+    std::shared_ptr<const Wavetable> get(const float *frames, int frameSize, int nFrames)
+    {
+        auto key = std::make_pair(hash(frames, (size_t)frameSize * nFrames), frameSize);
+
+        std::lock_guard<std::mutex> g(cacheMutex);
+        auto lu = cache.find(key);
+        if (lu != cache.end())
+        {
+            if (auto res = lu->second.lock())
+                return res;
+        }
+        auto res = Wavetable::build(frames, frameSize, nFrames);
+        cache[key] = res;
+        return res;
+    }
+
+    // forget entries whose tables have been released
+    void purge()
+    {
+        std::lock_guard<std::mutex> g(cacheMutex);
+        for (auto it = cache.begin(); it != cache.end();)
+            it = it->second.expired() ? cache.erase(it) : std::next(it);
+    }
+
+    size_t size()
+    {
+        std::lock_guard<std::mutex> g(cacheMutex);
+        return cache.size();
+    }
+
+  protected:
+    // FNV-1a over the sample bits
+    static uint64_t hash(const float *d, size_t n)
+    {
+        uint64_t h{1469598103934665603ULL};
+        for (size_t i = 0; i < n; ++i)
+        {
+            uint32_t b;
+            memcpy(&b, d + i, sizeof(b));
+            for (int k = 0; k < 4; ++k)
+            {
+                h ^= (b >> (8 * k)) & 0xFF;
+                h *= 1099511628211ULL;
+            }
+        }
+        return h;
+    }
+
+    std::mutex cacheMutex;
+    std::map<std::pair<uint64_t, int>, std::weak_ptr<const Wavetable>> cache;
+};
+
+/*
+ * Plays a Wavetable, morphing through its frames. As in MipMappedSampleReader, each block
+ * picks the two mip levels either side of the pitch and crossfades them; here both levels
+ * are alias free, with the top harmonic of the lower one between a quarter and a half of
+ * the sample rate, and a positive levelBias moves up the levels for a duller sound.
+ * Frequency and morph move linearly to their targets over each block. Four samples are
+ * rendered at a time, with the table reads gathered and the three interpolations (cubic
+ * in the frame, linear across frames and across levels) done in SIMD.
+ */
+template <int blockSize> struct WavetableOscillator
+{
+    static_assert(blockSize % 4 == 0, "Block size must be a multiple of 4");
+
+    float levelBias{0.f};
+
+    void setTable(std::shared_ptr<const Wavetable> t) { table = std::move(t); }
+    void setSampleRate(double sr) { sampleRateInv = 1.0 / sr; }
+
+    void setFrequency(double freqInHz)
+    {
+        dPhaseTarget = std::clamp(freqInHz * sampleRateInv, 0.0, 0.49);
+    }
+
+    // 0 is the first frame and 1 the last
+    void setMorph(float m) { morphTarget = std::clamp(m, 0.f, 1.f); }
+
+    void retrigger(float startPhase = 0.f)
+    {
+        phase = (uint32_t)((startPhase - std::floor(startPhase)) * 4294967296.0);
+        snapToTargets = true;
+    }
+
+    void processBlock(float *out)
+    {
+        if (!table)
+        {
+            std::fill(out, out + blockSize, 0.f);
+            return;
+        }
+        const auto &wt = *table;
+
+        if (snapToTargets)
+        {
+            dPhase = dPhaseTarget;
+            morph = morphTarget;
+            snapToTargets = false;
+        }
+        auto ddp = (dPhaseTarget - dPhase) / blockSize;
+        auto dm = (morphTarget - morph) / blockSize;
+
+        // levels for the fastest point of the block
+        auto lf = std::log2(std::max(std::max(dPhase, dPhaseTarget) * wt.frameSize, 1e-9)) +
+                  1 + levelBias;
+        lf = std::clamp(lf, 0.0, (double)(wt.nLevels - 1));
+        int l0 = (int)lf;
+        int l1 = std::min(l0 + 1, wt.nLevels - 1);
+        auto lw = SIMD_MM(set1_ps)((float)(lf - l0));
+
+        const auto fScale = SIMD_MM(set1_ps)(1.f / 16777216.f);
+        const auto lastFrame = (float)(wt.nFrames - 1);
+
+        uint32_t ph alignas(16)[4];
+        int fa[4], fb[4];
+        float mw alignas(16)[4];
+        for (int s = 0; s < blockSize; s += 4)
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                ph[i] = phase;
+                phase += (uint32_t)(dPhase * 4294967296.0);
+                dPhase += ddp;
+
+                auto fp = morph * lastFrame;
+                fa[i] = std::min((int)fp, wt.nFrames - 1);
+                fb[i] = std::min(fa[i] + 1, wt.nFrames - 1);
+                mw[i] = fp - fa[i];
+                morph += dm;
+            }
+            auto phv = SIMD_MM(load_si128)((const SIMD_M128I *)ph);
+            auto m = SIMD_MM(load_ps)(mw);
+
+            auto v0 = readLevel(wt, l0, phv, fa, fb, m, fScale);
+            auto v1 = readLevel(wt, l1, phv, fa, fb, m, fScale);
+            SIMD_MM(storeu_ps)(out + s, lerp(v0, v1, lw));
+        }
+        dPhase = dPhaseTarget;
+        morph = morphTarget;
+    }
+
+  protected:
+    static SIMD_M128 lerp(SIMD_M128 a, SIMD_M128 b, SIMD_M128 w)
+    {
+        return SIMD_MM(add_ps)(a, SIMD_MM(mul_ps)(SIMD_MM(sub_ps)(b, a), w));
+    }
+
+    static SIMD_M128 readLevel(const Wavetable &wt, int l, SIMD_M128I phv, const int *fa,
+                               const int *fb, SIMD_M128 m, SIMD_M128 fScale)
+    {
+        auto bits = wt.levelBits[l];
+        int32_t idx alignas(16)[4];
+        auto iv = SIMD_MM(srl_epi32)(phv, SIMD_MM(cvtsi32_si128)(32 - bits));
+        SIMD_MM(store_si128)((SIMD_M128I *)idx, iv);
+        // the 24 bits below the index are the fraction
+        auto fr = SIMD_MM(srli_epi32)(SIMD_MM(sll_epi32)(phv, SIMD_MM(cvtsi32_si128)(bits)), 8);
+        auto t = SIMD_MM(mul_ps)(SIMD_MM(cvtepi32_ps)(fr), fScale);
+
+        float a alignas(16)[4][4], b alignas(16)[4][4];
+        for (int i = 0; i < 4; ++i)
+        {
+            auto *pa = wt.frame(l, fa[i]) + idx[i] - 1;
+            auto *pb = wt.frame(l, fb[i]) + idx[i] - 1;
+            for (int k = 0; k < 4; ++k)
+            {
+                a[k][i] = pa[k];
+                b[k][i] = pb[k];
+            }
+        }
+        return lerp(cubic(a, t), cubic(b, t), m);
+    }
+
+    // catmull rom through p[1] and p[2], each of the four points a lane per sample
+    static SIMD_M128 cubic(const float (&p)[4][4], SIMD_M128 t)
+    {
+        auto p0 = SIMD_MM(load_ps)(p[0]), p1 = SIMD_MM(load_ps)(p[1]);
+        auto p2 = SIMD_MM(load_ps)(p[2]), p3 = SIMD_MM(load_ps)(p[3]);
+        auto c1 = SIMD_MM(sub_ps)(p2, p0);
+        auto c2 = SIMD_MM(sub_ps)(
+            SIMD_MM(add_ps)(SIMD_MM(add_ps)(p0, p0), SIMD_MM(mul_ps)(p2, SIMD_MM(set1_ps)(4.f))),
+            SIMD_MM(add_ps)(SIMD_MM(mul_ps)(p1, SIMD_MM(set1_ps)(5.f)), p3));
+        auto c3 = SIMD_MM(add_ps)(SIMD_MM(mul_ps)(SIMD_MM(sub_ps)(p1, p2), SIMD_MM(set1_ps)(3.f)),
+                                  SIMD_MM(sub_ps)(p3, p0));
+        auto r = SIMD_MM(add_ps)(c2, SIMD_MM(mul_ps)(t, c3));
+        r = SIMD_MM(add_ps)(c1, SIMD_MM(mul_ps)(t, r));
+        r = SIMD_MM(mul_ps)(SIMD_MM(mul_ps)(t, r), SIMD_MM(set1_ps)(0.5f));
+        return SIMD_MM(add_ps)(p1, r);
+    }
+
+    std::shared_ptr<const Wavetable> table;
+    double sampleRateInv{1.0 / 48000};
+    double dPhaseTarget{0}, dPhase{0};
+    float morphTarget{0}, morph{0};
+    uint32_t phase{0};
+    bool snapToTargets{true};
+};
+} // namespace sst::basic_blocks::dsp
+
+#endif // INCLUDE_SST_BASIC_BLOCKS_DSP_WAVETABLEOSCILLATOR_H
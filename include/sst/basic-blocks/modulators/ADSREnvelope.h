@@ -70,6 +70,39 @@ struct ADSREnvelope : DiscreteStagesEnvelope<BLOCK_SIZE, RangeProvider>
     void onSampleRateChanged()
     {
         coeff_offset = 2.f - std::log2(srProvider->samplerate * base_t::BLOCK_SIZE_INV);
+        base_t::invalidateStageCaches();
+    }
+
+    inline float rateFor(typename base_t::Stage st, float v)
+    {
+        return this->rateCache[st].get(v, 0, srProvider->samplerate, [this, v]() {
+            return srProvider->envelope_rate_linear_nowrap(v * base_t::etScale + base_t::etMin);
+        });
+    }
+
+    inline float analogCoefFor(typename base_t::Stage st, float v)
+    {
+        return this->coefCache[st].get(v, 0, srProvider->samplerate, [this, v]() {
+            return powf(2.f, std::min(0.f, coeff_offset - (v * base_t::etScale + base_t::etMin)));
+        });
+    }
+
+    // The decay target in the space of the decay shape
+    inline float shapedSustain(float s, int dshape)
+    {
+        return this->sustainShapeCache.get(s, dshape, srProvider->samplerate, [s, dshape]() {
+            auto S = s;
+            switch (dshape)
+            {
+            case 0:
+                S = S * S;
+                break;
+            case 2:
+                S = pow(S, 1.0 / 3.0);
+                break;
+            }
+            return S;
+        });
     }
 
     void attackFrom(float fv, float attack, int ashp, bool isdig)
@@ -129,7 +162,7 @@ struct ADSREnvelope : DiscreteStagesEnvelope<BLOCK_SIZE, RangeProvider>
         {
         case base_t::s_attack:
         {
-            phase += srProvider->envelope_rate_linear_nowrap(a * base_t::etScale + base_t::etMin);
+            phase += rateFor(base_t::s_attack, a);
             if (phase > 1)
             {
                 phase = 0;
@@ -142,23 +175,14 @@ struct ADSREnvelope : DiscreteStagesEnvelope<BLOCK_SIZE, RangeProvider>
 
         case base_t::s_decay:
         {
-            phase += srProvider->envelope_rate_linear_nowrap(d * base_t::etScale + base_t::etMin);
+            phase += rateFor(base_t::s_decay, d);
             if (phase > 1)
             {
                 phase = 0;
                 stage = base_t::s_sustain;
                 return s;
             }
-            auto S = s;
-            switch (dshape)
-            {
-            case 0:
-                S = S * S;
-                break;
-            case 2:
-                S = pow(S, 1.0 / 3.0);
-                break;
-            }
+            auto S = shapedSustain(s, dshape);
 
             auto dNorm = 1 - phase;
             dNorm = (dNorm) * (1.0 - S) + S;
@@ -174,7 +198,7 @@ struct ADSREnvelope : DiscreteStagesEnvelope<BLOCK_SIZE, RangeProvider>
         break;
         case base_t::s_release:
         {
-            phase += srProvider->envelope_rate_linear_nowrap(r * base_t::etScale + base_t::etMin);
+            phase += rateFor(base_t::s_release, r);
             if (phase > 1)
             {
                 phase = 0;
@@ -198,14 +222,9 @@ struct ADSREnvelope : DiscreteStagesEnvelope<BLOCK_SIZE, RangeProvider>
     {
         auto &stage = this->stage;
 
-        float coef_A =
-            powf(2.f, std::min(0.f, coeff_offset - (a * base_t::etScale + base_t::etMin)));
-        float coef_D =
-            powf(2.f, std::min(0.f, coeff_offset - (d * base_t::etScale + base_t::etMin)));
-        float coef_R =
-            (stage >= base_t::s_eoc)
-                ? 6.f
-                : pow(2.f, std::min(0.f, coeff_offset - (r * base_t::etScale + base_t::etMin)));
+        float coef_A = analogCoefFor(base_t::s_attack, a);
+        float coef_D = analogCoefFor(base_t::s_decay, d);
+        float coef_R = (stage >= base_t::s_eoc) ? 6.f : analogCoefFor(base_t::s_release, r);
 
         const float v_cc = 1.01f;
         float v_gate = gateActive ? v_cc : 0.f;
@@ -217,7 +236,7 @@ struct ADSREnvelope : DiscreteStagesEnvelope<BLOCK_SIZE, RangeProvider>
 
         if (stage == base_t::s_attack)
         {
-            phase += srProvider->envelope_rate_linear_nowrap(a * base_t::etScale + base_t::etMin);
+            phase += rateFor(base_t::s_attack, a);
             if (phase > 1)
             {
                 stage = base_t::s_decay;
@@ -227,16 +246,7 @@ struct ADSREnvelope : DiscreteStagesEnvelope<BLOCK_SIZE, RangeProvider>
         }
 
         float sparm = std::clamp(s, 0.f, 1.f);
-        float S = sparm; // * sparm;
-        switch (dshape)
-        {
-        case 0:
-            S = S * S;
-            break;
-        case 2:
-            S = pow(S, 1.0 / 3.0);
-            break;
-        }
+        float S = shapedSustain(sparm, dshape);
 
         float v_attack = discharge ? 0 : v_gate;
         float v_decay = discharge ? S : v_cc;
@@ -281,7 +291,7 @@ struct ADSREnvelope : DiscreteStagesEnvelope<BLOCK_SIZE, RangeProvider>
 
         if (stage == base_t::s_release)
         {
-            phase += srProvider->envelope_rate_linear_nowrap(r * base_t::etScale + base_t::etMin);
+            phase += rateFor(base_t::s_release, r);
             if (phase > 1)
             {
                 stage = base_t::s_analog_residual_release;
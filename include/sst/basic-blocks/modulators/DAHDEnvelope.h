@@ -67,6 +67,21 @@ struct DAHDEnvelope : DiscreteStagesEnvelope<BLOCK_SIZE, RangeProvider>
     void onSampleRateChanged()
     {
         coeff_offset = 2.f - std::log2(srProvider->samplerate * base_t::BLOCK_SIZE_INV);
+        base_t::invalidateStageCaches();
+    }
+
+    inline float rateFor(typename base_t::Stage st, float v)
+    {
+        return this->rateCache[st].get(v, 0, srProvider->samplerate, [this, v]() {
+            return srProvider->envelope_rate_linear_nowrap(v * base_t::etScale + base_t::etMin);
+        });
+    }
+
+    inline float analogCoefFor(typename base_t::Stage st, float v)
+    {
+        return this->coefCache[st].get(v, 0, srProvider->samplerate, [this, v]() {
+            return powf(2.f, std::min(0.f, coeff_offset - (v * base_t::etScale + base_t::etMin)));
+        });
     }
 
     void attackFrom(float fv, float attack, int ashp, bool isdig)
@@ -115,7 +130,7 @@ struct DAHDEnvelope : DiscreteStagesEnvelope<BLOCK_SIZE, RangeProvider>
         {
         case base_t::s_delay:
         {
-            phase += srProvider->envelope_rate_linear_nowrap(dly * base_t::etScale + base_t::etMin);
+            phase += rateFor(base_t::s_delay, dly);
             if (phase > 1)
             {
                 stage = base_t::s_attack;
@@ -127,7 +142,7 @@ struct DAHDEnvelope : DiscreteStagesEnvelope<BLOCK_SIZE, RangeProvider>
         break;
         case base_t::s_attack:
         {
-            phase += srProvider->envelope_rate_linear_nowrap(a * base_t::etScale + base_t::etMin);
+            phase += rateFor(base_t::s_attack, a);
             if (phase > 1)
             {
                 phase = 0;
@@ -139,7 +154,7 @@ struct DAHDEnvelope : DiscreteStagesEnvelope<BLOCK_SIZE, RangeProvider>
         break;
         case base_t::s_sustain:
         {
-            phase += srProvider->envelope_rate_linear_nowrap(h * base_t::etScale + base_t::etMin);
+            phase += rateFor(base_t::s_sustain, h);
             if (phase > 1)
             {
                 phase = 0;
@@ -151,7 +166,7 @@ struct DAHDEnvelope : DiscreteStagesEnvelope<BLOCK_SIZE, RangeProvider>
         break;
         case base_t::s_release:
         {
-            phase += srProvider->envelope_rate_linear_nowrap(d * base_t::etScale + base_t::etMin);
+            phase += rateFor(base_t::s_release, d);
             if (phase > 1)
             {
                 phase = 0;
@@ -176,7 +191,7 @@ struct DAHDEnvelope : DiscreteStagesEnvelope<BLOCK_SIZE, RangeProvider>
 
         if (stage == base_t::s_delay)
         {
-            phase += srProvider->envelope_rate_linear_nowrap(dly * base_t::etScale + base_t::etMin);
+            phase += rateFor(base_t::s_delay, dly);
             if (phase > 1)
             {
                 stage = base_t::s_attack;
@@ -187,7 +202,7 @@ struct DAHDEnvelope : DiscreteStagesEnvelope<BLOCK_SIZE, RangeProvider>
 
         if (stage == base_t::s_sustain)
         {
-            phase += srProvider->envelope_rate_linear_nowrap(h * base_t::etScale + base_t::etMin);
+            phase += rateFor(base_t::s_sustain, h);
             if (phase > 1)
             {
                 stage = base_t::s_release;
@@ -211,14 +226,8 @@ struct DAHDEnvelope : DiscreteStagesEnvelope<BLOCK_SIZE, RangeProvider>
         auto v_decay = (!discharge) * v_gate;
 
         // In this case we only need the coefs in their stage
-        float coef_A =
-            !discharge
-                ? powf(2.f, std::min(0.f, coeff_offset - (a * base_t::etScale + base_t::etMin)))
-                : 0;
-        float coef_D =
-            discharge
-                ? powf(2.f, std::min(0.f, coeff_offset - (d * base_t::etScale + base_t::etMin)))
-                : 0;
+        float coef_A = !discharge ? analogCoefFor(base_t::s_attack, a) : 0;
+        float coef_D = discharge ? analogCoefFor(base_t::s_release, d) : 0;
 
         auto diff_v_a = std::max(0.f, v_attack - v_c1);
         auto diff_v_d = std::min(0.f, v_decay - v_c1);
@@ -228,7 +237,7 @@ struct DAHDEnvelope : DiscreteStagesEnvelope<BLOCK_SIZE, RangeProvider>
 
         if (stage == base_t::s_release)
         {
-            phase -= srProvider->envelope_rate_linear_nowrap(d * base_t::etScale + base_t::etMin);
+            phase -= rateFor(base_t::s_release, d);
             if (phase <= 0)
             {
                 this->eoc_countdown = (int)std::round(srProvider->samplerate * 0.01);
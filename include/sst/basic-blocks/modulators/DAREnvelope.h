@@ -94,13 +94,14 @@ struct DAREnvelope : DiscreteStagesEnvelope<BLOCK_SIZE, RangeProvider>
                 return BLOCK_SIZE * srProvider->sampleRateInv * 2.0 * temposyncRatio / beats;
             }
 
-            auto timeInSeconds =
-                (std::exp(RangeProvider::A + x * (RangeProvider::B - RangeProvider::A)) -
-                 RangeProvider::C) /
-                RangeProvider::D;
-            auto dPhase = BLOCK_SIZE * srProvider->sampleRateInv / timeInSeconds;
-
-            return dPhase;
+            // The exp is the expensive part and x rarely moves so memoize per stage
+            return this->rateCache[this->stage].get(x, 0, srProvider->sampleRateInv, [this, x]() {
+                auto timeInSeconds =
+                    (std::exp(RangeProvider::A + x * (RangeProvider::B - RangeProvider::A)) -
+                     RangeProvider::C) /
+                    RangeProvider::D;
+                return (float)(BLOCK_SIZE * srProvider->sampleRateInv / timeInSeconds);
+            });
         }
     }
 
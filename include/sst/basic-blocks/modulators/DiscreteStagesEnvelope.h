@@ -27,6 +27,9 @@
 #ifndef INCLUDE_SST_BASIC_BLOCKS_MODULATORS_DISCRETESTAGESENVELOPE_H
 #define INCLUDE_SST_BASIC_BLOCKS_MODULATORS_DISCRETESTAGESENVELOPE_H
 
+#include <cstring>
+#include <limits>
+
 namespace sst::basic_blocks::modulators
 {
 enum DPhaseStrategies
@@ -68,8 +71,29 @@ struct TwentyFiveSecondExp
     static constexpr double A{0.6931471824646}, B{10.1267113685608}, C{-2.0}, D{1000.0};
 };
 
+/*
+ * Most consumers only read output (or the outputCache block) so the per sample cube is
+ * wasted work. A RangeProvider can opt out of it by declaring
+ * static constexpr bool computeCubedOutput{false}, which NoCubedOutput<> does for you;
+ * for instance ADSREnvelope<SRP, 32, NoCubedOutput<TenSecondRange>>
+ */
+template <typename RangeProvider> constexpr bool rangeComputesCubedOutput()
+{
+    if constexpr (requires { RangeProvider::computeCubedOutput; })
+        return RangeProvider::computeCubedOutput;
+    else
+        return true;
+}
+
+template <typename RangeProvider> struct NoCubedOutput : RangeProvider
+{
+    static constexpr bool computeCubedOutput{false};
+};
+
 template <int BLOCK_SIZE, typename RangeProvider> struct DiscreteStagesEnvelope
 {
+    static constexpr bool computeCubedOutput{rangeComputesCubedOutput<RangeProvider>()};
+
     static constexpr float etminV()
     {
         if constexpr (RangeProvider::phaseStrategy == ENVTIME_2TWOX)
@@ -103,7 +127,7 @@ template <int BLOCK_SIZE, typename RangeProvider> struct DiscreteStagesEnvelope
         for (int i = 0; i < BLOCK_SIZE; ++i)
         {
             outputCache[i] = 0;
-            outputCacheCubed[0] = 0;
+            outputCacheCubed[i] = 0;
         }
     }
 
@@ -127,6 +151,44 @@ template <int BLOCK_SIZE, typename RangeProvider> struct DiscreteStagesEnvelope
         s_complete
     } stage{s_complete};
 
+    /*
+     * Per-stage derived values (rates, analog coefficients, shaped sustain levels) only
+     * move when the parameter, shape or sample rate move, but the envelopes ask for them
+     * every block. A StageCache memoizes one such value; the key includes the sample rate
+     * and invalidateStageCaches() handles anything else a subclass derives from it.
+     */
+    struct StageCache
+    {
+        float key{std::numeric_limits<float>::quiet_NaN()};
+        int shape{0};
+        double sampleRate{0};
+        float value{0};
+
+        template <typename F> inline float get(float k, int shp, double sr, F &&compute)
+        {
+            if (k != key || shp != shape || sr != sampleRate)
+            {
+                key = k;
+                shape = shp;
+                sampleRate = sr;
+                value = compute();
+            }
+            return value;
+        }
+
+        void invalidate() { key = std::numeric_limits<float>::quiet_NaN(); }
+    };
+    StageCache rateCache[s_complete + 1], coefCache[s_complete + 1], sustainShapeCache;
+
+    void invalidateStageCaches()
+    {
+        for (auto &c : rateCache)
+            c.invalidate();
+        for (auto &c : coefCache)
+            c.invalidate();
+        sustainShapeCache.invalidate();
+    }
+
     void resetCurrent()
     {
         current = BLOCK_SIZE;
@@ -209,6 +271,12 @@ template <int BLOCK_SIZE, typename RangeProvider> struct DiscreteStagesEnvelope
 
     void updateBlockTo(float target)
     {
+        if constexpr (!computeCubedOutput)
+        {
+            updateBlockToNoCube(target);
+            return;
+        }
+
         float dO = (target - outBlock0) * BLOCK_SIZE_INV;
         for (int i = 0; i < BLOCK_SIZE; ++i)
         {
@@ -233,10 +301,22 @@ template <int BLOCK_SIZE, typename RangeProvider> struct DiscreteStagesEnvelope
     void step()
     {
         output = outputCache[current];
-        outputCubed = outputCacheCubed[current];
+        if constexpr (computeCubedOutput)
+            outputCubed = outputCacheCubed[current];
         current++;
     }
 
+    /*
+     * After a processBlock style call the whole block is in outputCache, so rather than
+     * stepping per sample you can hand these straight to a lipol or VCA multiply.
+     */
+    const float *outputBlock() const { return outputCache; }
+    const float *outputCubedBlock() const
+    {
+        static_assert(computeCubedOutput, "Cubed output is disabled by the RangeProvider");
+        return outputCacheCubed;
+    }
+
     void immediatelySilence()
     {
         output = 0;
@@ -30,6 +30,7 @@
 #include <cmath>
 #include <utility>
 #include <array>
+#include <memory>
 
 #include "sst/basic-blocks/dsp/BlockInterpolators.h"
 #include "sst/basic-blocks/dsp/RNG.h"
@@ -61,6 +62,61 @@ enum RandomBehavior
     rnd_quad,
 };
 
+/*
+ * The sine table shared by every FXModControl which doesn't bring its own. It is built once
+ * per process on first use (function statics make that thread safe) so creating an
+ * instance is free. Each entry is stored as the pair sin[i], sin[i+1] - sin[i] so a lane of
+ * the four phase lookup is one 64 bit load and a multiply-add.
+ */
+struct FXModControlSineTable
+{
+    static constexpr int tableSize{8192};
+    static constexpr int tableMask{tableSize - 1};
+
+    static const float *interleaved()
+    {
+        static const auto table = []() {
+            auto res = std::make_unique<float[]>(2 * tableSize);
+            for (int i = 0; i < tableSize; ++i)
+            {
+                auto v = std::sin(2.0 * M_PI * i / tableSize);
+                auto vn = std::sin(2.0 * M_PI * ((i + 1) & tableMask) / tableSize);
+                res[2 * i] = (float)v;
+                res[2 * i + 1] = (float)vn - (float)v;
+            }
+            return res;
+        }();
+        return table.get();
+    }
+
+    // phase in [0,1) for four lanes; returns the linearly interpolated sine for each
+    static inline SIMD_M128 lookup(SIMD_M128 phase)
+    {
+        const auto *t = interleaved();
+
+        auto ps = SIMD_MM(mul_ps)(phase, SIMD_MM(set1_ps)((float)tableSize));
+        auto psi = SIMD_MM(cvttps_epi32)(ps);
+        auto psf = SIMD_MM(sub_ps)(ps, SIMD_MM(cvtepi32_ps)(psi));
+        psi = SIMD_MM(and_si128)(psi, SIMD_MM(set1_epi32)(tableMask));
+
+        int idx alignas(16)[4];
+        SIMD_MM(store_si128)((SIMD_M128I *)idx, psi);
+
+        auto p0 = SIMD_MM(loadl_epi64)((const SIMD_M128I *)(t + 2 * idx[0]));
+        auto p1 = SIMD_MM(loadl_epi64)((const SIMD_M128I *)(t + 2 * idx[1]));
+        auto p2 = SIMD_MM(loadl_epi64)((const SIMD_M128I *)(t + 2 * idx[2]));
+        auto p3 = SIMD_MM(loadl_epi64)((const SIMD_M128I *)(t + 2 * idx[3]));
+
+        // (v0 d0 v1 d1) and (v2 d2 v3 d3) then deinterleave into v and d
+        auto p01 = SIMD_MM(castsi128_ps)(SIMD_MM(unpacklo_epi64)(p0, p1));
+        auto p23 = SIMD_MM(castsi128_ps)(SIMD_MM(unpacklo_epi64)(p2, p3));
+        auto v = SIMD_MM(shuffle_ps)(p01, p23, SIMD_MM_SHUFFLE(2, 0, 2, 0));
+        auto d = SIMD_MM(shuffle_ps)(p01, p23, SIMD_MM_SHUFFLE(3, 1, 3, 1));
+
+        return SIMD_MM(add_ps)(v, SIMD_MM(mul_ps)(psf, d));
+    }
+};
+
 template <int blockSize, RandomBehavior RB = rnd_dual_stereo, bool externalSineTable = false>
 struct FXModControl
 {
@@ -81,8 +137,8 @@ struct FXModControl
         }
         else
         {
-            for (int i = 0; i < 8192; ++i)
-                sine[i] = std::sin(2.0 * M_PI * i / 8192);
+            // Make sure the shared table is built here rather than on the audio thread
+            FXModControlSineTable::interleaved();
         }
     }
 
@@ -185,26 +241,37 @@ struct FXModControl
         {
         case mod_sine:
         {
-            // float ps = thisphase * LFO_TABLE_SIZE;
-            auto psSSE = MUL(phaseSSE, LFO_TABLE_SIZE_SSE);
-
-            // int psi = (int)ps;
-            auto psiSSE = SIMD_MM(cvttps_epi32(psSSE));
-            // int psn = (psi + 1) & LFO_TABLE_MASK;
-            auto psnSSE = SIMD_MM(and_si128)(SIMD_MM(add_epi32)(psiSSE, SIMD_MM(set1_epi32)(1)),
-                                             LFO_TABLE_MASK_SSE);
-            // float psf = ps - psi;
-            auto psfSSE = SUB(psSSE, SIMD_MM(cvtepi32_ps)(psiSSE));
-
-            SIMD_M128 v = SIMD_MM(set_ps)(
-                sine[SIMD_MM(extract_epi32)(psiSSE, 3)], sine[SIMD_MM(extract_epi32)(psiSSE, 2)],
-                sine[SIMD_MM(extract_epi32)(psiSSE, 1)], sine[SIMD_MM(extract_epi32)(psiSSE, 0)]);
-            SIMD_M128 vn = SIMD_MM(set_ps)(
-                sine[SIMD_MM(extract_epi32)(psnSSE, 3)], sine[SIMD_MM(extract_epi32)(psnSSE, 2)],
-                sine[SIMD_MM(extract_epi32)(psnSSE, 1)], sine[SIMD_MM(extract_epi32)(psnSSE, 0)]);
-
-            // lfoout = sin_lfo_table[psi] * (1.0 - psf) + psf * sin_lfo_table[psn];
-            auto sineish = ADD(MUL(v, SUB(oneSSE, psfSSE)), MUL(psfSSE, vn));
+            SIMD_M128 sineish;
+            if constexpr (externalSineTable)
+            {
+                // float ps = thisphase * LFO_TABLE_SIZE;
+                auto psSSE = MUL(phaseSSE, LFO_TABLE_SIZE_SSE);
+
+                // int psi = (int)ps & LFO_TABLE_MASK;
+                auto psiSSE = SIMD_MM(cvttps_epi32(psSSE));
+                // int psn = (psi + 1) & LFO_TABLE_MASK;
+                auto psnSSE = SIMD_MM(and_si128)(
+                    SIMD_MM(add_epi32)(psiSSE, SIMD_MM(set1_epi32)(1)), LFO_TABLE_MASK_SSE);
+                // float psf = ps - psi;
+                auto psfSSE = SUB(psSSE, SIMD_MM(cvtepi32_ps)(psiSSE));
+                psiSSE = SIMD_MM(and_si128)(psiSSE, LFO_TABLE_MASK_SSE);
+
+                SIMD_M128 v = SIMD_MM(set_ps)(sine[SIMD_MM(extract_epi32)(psiSSE, 3)],
+                                              sine[SIMD_MM(extract_epi32)(psiSSE, 2)],
+                                              sine[SIMD_MM(extract_epi32)(psiSSE, 1)],
+                                              sine[SIMD_MM(extract_epi32)(psiSSE, 0)]);
+                SIMD_M128 vn = SIMD_MM(set_ps)(sine[SIMD_MM(extract_epi32)(psnSSE, 3)],
+                                               sine[SIMD_MM(extract_epi32)(psnSSE, 2)],
+                                               sine[SIMD_MM(extract_epi32)(psnSSE, 1)],
+                                               sine[SIMD_MM(extract_epi32)(psnSSE, 0)]);
+
+                // lfoout = sin_lfo_table[psi] * (1.0 - psf) + psf * sin_lfo_table[psn];
+                sineish = ADD(MUL(v, SUB(oneSSE, psfSSE)), MUL(psfSSE, vn));
+            }
+            else
+            {
+                sineish = FXModControlSineTable::lookup(phaseSSE);
+            }
 
             float res alignas(16)[4];
             SIMD_MM(store_ps)(res, sineish);
@@ -577,8 +644,8 @@ struct FXModControl
 
     static constexpr int LFO_TABLE_SIZE = 8192;
     static constexpr int LFO_TABLE_MASK = LFO_TABLE_SIZE - 1;
-    using sineTableType = std::conditional<externalSineTable, float *, float[LFO_TABLE_SIZE]>::type;
-    sineTableType sine;
+    // Only used with an external table; otherwise we read FXModControlSineTable
+    float *sine{nullptr};
 
     const SIMD_M128 LFO_TABLE_SIZE_SSE = SIMD_MM(set_ps)(
         (float)LFO_TABLE_SIZE, (float)LFO_TABLE_SIZE, (float)LFO_TABLE_SIZE, (float)LFO_TABLE_SIZE);
@@ -27,7 +27,10 @@
 #ifndef INCLUDE_SST_BASIC_BLOCKS_MODULATORS_STEPLFO_H
 #define INCLUDE_SST_BASIC_BLOCKS_MODULATORS_STEPLFO_H
 
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <limits>
 #include "Transport.h"
 #include "sst/basic-blocks/dsp/RNG.h"
 #include "sst/basic-blocks/tables/EqualTuningProvider.h"
@@ -77,22 +80,73 @@ template <size_t blockSize> struct StepLFO
             double ipart; //,tsrate = localcopy[rate].f;
             phase = (float)modf(0.5f * td->timeInBeats * pow(2.0, (double)rate), &ipart);
             int i = (int)ipart;
-            state = i % storage->repeat;
+            state = wrapStep(i);
         }
 
         // move state one step ahead to reflect the lag in the interpolation
-        state = (state + 1) % storage->repeat;
-        for (int i = 0; i < 4; i++)
-            wf_history[i] = storage->data[((state + storage->repeat - i) % storage->repeat) & 0x1f];
+        state = wrapStep(state + 1);
+        rebuildHistory();
+        lockedStep = noLockedStep;
 
         UpdatePhaseIncrement(rate, tempoSync);
     }
 
+    /*
+     * Step indices wrap on storage->repeat. The common 4, 8, 16 and 32 step patterns
+     * are powers of two so take the mask rather than the modulo there.
+     */
+    inline long wrapStep(long s) const
+    {
+        auto r = (long)storage->repeat;
+        if ((r & (r - 1)) == 0)
+            return s & (r - 1);
+        return ((s % r) + r) % r;
+    }
+
+    inline void rebuildHistory()
+    {
+        for (int i = 0; i < 4; i++)
+            wf_history[i] = storage->data[wrapStep(state - i) & (Storage::stepLfoSteps - 1)];
+    }
+
+    // A finished one shot: no look ahead to wrap onto, so every interpolation point is the end
+    inline void holdLastStep()
+    {
+        state = storage->repeat - 1;
+        for (int i = 0; i < 4; i++)
+            wf_history[i] = storage->data[state & (Storage::stepLfoSteps - 1)];
+        phase = 0;
+    }
+
     float lrate{-10000};
     double tsVal{0.f};
+
+    // Everything the phase increment depends on, so we only recompute it when one moves
+    struct PhaseIncKey
+    {
+        float rate{-10000};
+        bool tempoSync{false};
+        double tempo{0}, samplerate_inv{0};
+        int16_t repeat{0};
+        bool rateIsForSingleStep{false};
+
+        bool operator==(const PhaseIncKey &) const = default;
+    } phaseIncKey;
+
     void UpdatePhaseIncrement(float rate, bool tempoSync)
     {
-        if (tempoSync && td)
+        auto ts = tempoSync && td;
+        auto key = PhaseIncKey{rate,
+                               ts,
+                               ts ? td->tempo : 0.0,
+                               samplerate_inv,
+                               storage->repeat,
+                               storage->rateIsForSingleStep};
+        if (key == phaseIncKey)
+            return;
+        phaseIncKey = key;
+
+        if (ts)
         {
             // Temposync rates change less often and need full
             // double precision to avoid drift fo things like
@@ -125,9 +179,9 @@ template <size_t blockSize> struct StepLFO
         phase = 0;
 
         // Again a 1 step lag in interpolation
-        state = (state + 1) % storage->repeat;
-        for (int i = 0; i < 4; i++)
-            wf_history[i] = storage->data[((state + storage->repeat - i) % storage->repeat) & 0x1f];
+        state = wrapStep(state + 1);
+        rebuildHistory();
+        lockedStep = noLockedStep;
     }
 
     void setPhaseTo(int step, float ph)
@@ -135,13 +189,13 @@ template <size_t blockSize> struct StepLFO
         if (!storage || storage->repeat <= 0)
             return;
 
-        state = ((step % storage->repeat) + storage->repeat) % storage->repeat;
+        state = wrapStep(step);
         phase = std::clamp(ph, 0.f, 1.f);
 
         // match the 1-step interpolation lag applied in assign/retrigger
-        state = (state + 1) % storage->repeat;
-        for (int i = 0; i < 4; i++)
-            wf_history[i] = storage->data[((state + storage->repeat - i) % storage->repeat) & 0x1f];
+        state = wrapStep(state + 1);
+        rebuildHistory();
+        lockedStep = noLockedStep;
 
         output = std::clamp(lfo_ipol(wf_history, phase, storage->smooth, state & 1), -1.f, 1.f);
     }
@@ -175,14 +229,115 @@ template <size_t blockSize> struct StepLFO
         output = std::clamp(lfo_ipol(wf_history, phase, storage->smooth, state & 1), -1.f, 1.f);
     }
 
+    /*
+     * Transport locked, sample accurate stepping. Rather than accumulating phaseInc, the
+     * step position comes straight from td->timeInBeats at the start of each block (so it
+     * never drifts from the host), and every sample of outputBlock is interpolated at its
+     * own phase, so a step boundary lands on its exact sample rather than the next block.
+     * stepBoundaryOffset is the sample in this block at which the last new step began, or -1.
+     * The rate is in the tempo synced units of process(); output is the last sample. A one
+     * shot holds the last step's value once it gets there, as process() does.
+     */
+    float outputBlock alignas(16)[blockSize]{};
+    int stepBoundaryOffset{-1};
+
+    void processTransportLocked(float rate, bool oneShot)
+    {
+        if (!storage || !td)
+            return;
+
+        if (lrate != rate)
+        {
+            tsVal = pow(2.0, rate);
+            lrate = rate;
+        }
+        auto stepsPerBeat = 0.5 * tsVal * (storage->rateIsForSingleStep ? 1 : storage->repeat);
+        auto dPos = stepsPerBeat * td->tempo * (1.0 / 60.0) * samplerate_inv;
+
+        auto pos = td->timeInBeats * stepsPerBeat;
+        auto whole = std::floor(pos);
+        auto absStep = (long)whole;
+        const auto lastStep = (long)(storage->repeat - 1);
+        if (oneShot)
+            absStep = std::clamp(absStep, 0L, lastStep);
+        if (absStep != lockedStep)
+        {
+            lockedStep = absStep;
+            if (oneShot && lockedStep >= lastStep)
+            {
+                holdLastStep();
+            }
+            else
+            {
+                state = wrapStep(lockedStep + 1);
+                rebuildHistory();
+            }
+        }
+        bool holding = oneShot && lockedStep >= lastStep;
+        phase = holding ? 0.0 : pos - whole;
+
+        stepBoundaryOffset = -1;
+        for (size_t i = 0; i < blockSize; ++i)
+        {
+            if (!holding && phase >= 1.0)
+            {
+                phase -= 1.0;
+                lockedStep++;
+                stepBoundaryOffset = (int)i;
+                if (oneShot && lockedStep >= lastStep)
+                {
+                    holdLastStep();
+                    holding = true;
+                }
+                else
+                {
+                    state = wrapStep(lockedStep + 1);
+                    wf_history[3] = wf_history[2];
+                    wf_history[2] = wf_history[1];
+                    wf_history[1] = wf_history[0];
+                    wf_history[0] = storage->data[state & (Storage::stepLfoSteps - 1)];
+                }
+            }
+            outputBlock[i] =
+                std::clamp(lfo_ipol(wf_history, phase, storage->smooth, state & 1), -1.f, 1.f);
+            if (!holding)
+                phase += dPos;
+        }
+        output = outputBlock[blockSize - 1];
+    }
+
     float QuadraticBSpline(float y0, float y1, float y2, float mu)
     {
         return 0.5f *
                (y2 * (mu * mu) + y1 * (-2 * mu * mu + 2 * mu + 1) + y0 * (mu * mu - 2 * mu + 1));
     }
+    /*
+     * The interpolation shape only depends on smooth, so we keep its reciprocals
+     * around and only recompute them when smooth moves, rather than dividing per call.
+     */
+    struct IpolCoefficients
+    {
+        float smooth{-1000.f};
+        float df{0.f}, invSlope{0.f}, invNegSlope{0.f}, invHold{0.f};
+    } ipolCoeffs;
+
+    void updateIpolCoefficients(float smooth)
+    {
+        if (smooth == ipolCoeffs.smooth)
+            return;
+        auto &c = ipolCoeffs;
+        c.smooth = smooth;
+        c.df = smooth * 0.5f;
+        c.invSlope = 1.f / (2.f * c.df + 0.00001f);
+        c.invNegSlope = 1.f / (-2.f * c.df + 0.00001f);
+        c.invHold = 1.f / (2.f + 2.f * c.df + 0.00001f);
+    }
+
     float lfo_ipol(float *wf_history, float phase, float smooth, int odd)
     {
-        float df = smooth * 0.5f;
+        updateIpolCoefficients(smooth);
+        const auto &c = ipolCoeffs;
+        float df = c.df;
         float iout;
 
         if (df > 0.5f)
@@ -208,25 +363,25 @@ template <size_t blockSize> struct StepLFO
         {
             if (phase > 0.5f)
             {
-                float cf = 0.5f - (phase - 1.f) / (2.f * df + 0.00001f);
+                float cf = 0.5f - (phase - 1.f) * c.invSlope;
                 cf = std::max(0.f, std::min(cf, 1.0f));
                 iout = (1.f - cf) * wf_history[0] + cf * wf_history[1];
             }
             else
             {
-                float cf = 0.5f - (phase) / (2.f * df + 0.00001f);
+                float cf = 0.5f - phase * c.invSlope;
                 cf = std::max(0.f, std::min(cf, 1.0f));
                 iout = (1.f - cf) * wf_history[1] + cf * wf_history[2];
             }
         }
         else if (df > -0.5f)
         {
-            float cf = std::max(0.f, std::min((1.f - phase) / (-2.f * df + 0.00001f), 1.0f));
+            float cf = std::max(0.f, std::min((1.f - phase) * c.invNegSlope, 1.0f));
             iout = (1.f - cf) * 0 + cf * wf_history[1];
         }
         else
         {
-            float cf = std::max(0.f, std::min(phase / (2.f + 2.f * df + 0.00001f), 1.0f));
+            float cf = std::max(0.f, std::min(phase * c.invHold, 1.0f));
             iout = (1.f - cf) * wf_history[1] + cf * 0;
         }
         return iout;
@@ -248,6 +403,8 @@ template <size_t blockSize> struct StepLFO
   protected:
     long state{0};
     long state_tminus1{0};
+    static constexpr long noLockedStep{std::numeric_limits<long>::min()};
+    long lockedStep{noLockedStep};
     double phaseInc{0};
     float wf_history[4]{0.f, 0.f, 0.f, 0.f};
     float ratemult{1.f};
@@ -0,0 +1,76 @@
+/*
+ * sst-basic-blocks - an open source library of core audio utilities
+ * built by Surge Synth Team.
+ *
+ * Provides a collection of tools useful on the audio thread for blocks,
+ * modulation, etc... or useful for adapting code to multiple environments.
+ *
+ * Copyright 2023, various authors, as described in the GitHub
+ * transaction log. Parts of this code are derived from similar
+ * functions original in Surge or ShortCircuit.
+ *
+ * sst-basic-blocks is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html.
+ *
+ * A very small number of explicitly chosen header files can also be
+ * used in an MIT/BSD context. Please see the README.md file in this
+ * repo or the comments in the individual files. Only headers with an
+ * explicit mention that they are dual licensed may be copied and reused
+ * outside the GPL3 terms.
+ *
+ * All source in sst-basic-blocks available at
+ * https://github.com/surge-synthesizer/sst-basic-blocks
+ */
+
+#ifndef INCLUDE_SST_BASIC_BLOCKS_TABLES_CONSTEXPRMATH_H
+#define INCLUDE_SST_BASIC_BLOCKS_TABLES_CONSTEXPRMATH_H
+
+#include <array>
+#include <cstddef>
+
+namespace sst::basic_blocks::tables::detail
+{
+/*
+ * Just enough constexpr math to generate the exponential tables at compile time, since
+ * std::pow isn't constexpr. These are double precision (a few ulp) which is far more than
+ * the float tables they fill need.
+ */
+inline constexpr double constexprPow2(double y)
+{
+    // split into an exact power of two and a fraction in [0,1) for the series
+    auto n = (long long)y;
+    if ((double)n > y)
+        n--;
+    auto f = (y - (double)n) * 0.693147180559945309417232121458;
+
+    double term{1}, sum{1};
+    for (int k = 1; k < 30; ++k)
+    {
+        term *= f / k;
+        sum += term;
+    }
+
+    for (; n > 0; --n)
+        sum *= 2;
+    for (; n < 0; ++n)
+        sum *= 0.5;
+    return sum;
+}
+
+inline constexpr double constexprPow10(double x)
+{
+    return constexprPow2(x * 3.32192809488736234787031942949);
+}
+
+template <size_t N, typename F> inline constexpr std::array<float, N> makeTable(F &&f)
+{
+    std::array<float, N> r{};
+    for (size_t i = 0; i < N; ++i)
+        r[i] = f(i);
+    return r;
+}
+} // namespace sst::basic_blocks::tables::detail
+
+#endif // INCLUDE_SST_BASIC_BLOCKS_TABLES_CONSTEXPRMATH_H
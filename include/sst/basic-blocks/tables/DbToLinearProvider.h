@@ -27,22 +27,34 @@
 #ifndef INCLUDE_SST_BASIC_BLOCKS_TABLES_DBTOLINEARPROVIDER_H
 #define INCLUDE_SST_BASIC_BLOCKS_TABLES_DBTOLINEARPROVIDER_H
 
+#include <array>
 #include <cmath>
+#include <cstddef>
+
+#include "ConstexprMath.h"
+#include "TableGather.h"
 
 namespace sst::basic_blocks::tables
 {
+namespace detail::db_to_linear
+{
+inline constexpr size_t nPoints{512};
+// one guard point past the end repeats the first, so (e, e+1) stay adjacent when e wraps
+alignas(16) inline constexpr std::array<float, nPoints + 1> table_dB =
+    makeTable<nPoints + 1>([](size_t i) {
+        return (float)constexprPow10(0.05f * ((float)(i & (nPoints - 1)) - 384.f));
+    });
+} // namespace detail::db_to_linear
+
+/*
+ * The table is built at compile time; init() is kept as a no-op for existing callers.
+ */
 struct DbToLinearProvider
 {
-    static constexpr size_t nPoints{512};
+    static constexpr size_t nPoints{detail::db_to_linear::nPoints};
     static_assert(!(nPoints & (nPoints - 1)));
 
-    void init()
-    {
-        for (auto i = 0U; i < nPoints; i++)
-        {
-            table_dB[i] = powf(10.f, 0.05f * ((float)i - 384.f));
-        }
-    }
+    void init() {}
     float dbToLinear(float db) const
     {
         db += 384;
@@ -52,8 +64,31 @@ struct DbToLinearProvider
         return (1.f - a) * table_dB[e & (nPoints - 1)] + a * table_dB[(e + 1) & (nPoints - 1)];
     }
 
+    // dbToLinear for four lanes, with the same wrap around outside the table as the scalar
+    SIMD_M128 dbToLinear(SIMD_M128 db) const
+    {
+        db = SIMD_MM(add_ps)(db, SIMD_MM(set1_ps)(384.f));
+        auto e = SIMD_MM(cvttps_epi32)(db);
+        auto a = SIMD_MM(sub_ps)(db, SIMD_MM(cvtepi32_ps)(e));
+
+        SIMD_M128 t0, t1;
+        detail::gatherAdjacent(table_dB.data(),
+                               SIMD_MM(and_si128)(e, SIMD_MM(set1_epi32)(nPoints - 1)), t0, t1);
+        return detail::lerp(a, t0, t1);
+    }
+
+    // db and out are 16 byte aligned blocks
+    template <size_t blockSize>
+    void dbToLinear(const float *__restrict db, float *__restrict out) const
+    {
+        static_assert(!(blockSize & 3), "Block size must be a multiple of four");
+        for (auto i = 0U; i < blockSize; i += 4)
+            SIMD_MM(store_ps)(out + i, dbToLinear(SIMD_MM(load_ps)(db + i)));
+    }
+
   private:
-    float table_dB[nPoints];
+    static constexpr const std::array<float, nPoints + 1> &table_dB{
+        detail::db_to_linear::table_dB};
 };
 } // namespace sst::basic_blocks::tables
 #endif // SHORTCIRCUITXT_DBTOLINEARPROVIDER_H
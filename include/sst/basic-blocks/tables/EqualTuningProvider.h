@@ -32,30 +32,37 @@
 #include <cmath>
 #include <math.h>
 #include <algorithm>
+#include <array>
+
+#include "ConstexprMath.h"
+#include "TableGather.h"
 
 namespace sst::basic_blocks::tables
 {
-struct EqualTuningProvider
+namespace detail::equal_tuning
 {
-    void init()
-    {
-        if (initialized)
-            return;
+inline constexpr size_t tuning_table_size{512};
+inline constexpr size_t nInterp{1001};
 
-        for (auto i = 0U; i < tuning_table_size; i++)
-        {
-            table_pitch[i] = powf(2.f, ((float)i - 256.f) * (1.f / 12.f));
-            table_pitch_inv[i] = 1.f / table_pitch[i];
-        }
+alignas(16) inline constexpr std::array<float, tuning_table_size> table_pitch =
+    makeTable<tuning_table_size>([](size_t i) {
+        return (float)constexprPow2(((float)i - 256.f) * (1.f / 12.f));
+    });
+alignas(16) inline constexpr std::array<float, tuning_table_size> table_pitch_inv =
+    makeTable<tuning_table_size>([](size_t i) { return 1.f / table_pitch[i]; });
+alignas(16) inline constexpr std::array<float, nInterp> table_two_to_the =
+    makeTable<nInterp>([](size_t i) { return (float)constexprPow2(i * 1.0 / 12.0 / 1000.0); });
+alignas(16) inline constexpr std::array<float, nInterp> table_two_to_the_minus =
+    makeTable<nInterp>([](size_t i) { return (float)constexprPow2(-(i * 1.0 / 12.0 / 1000.0)); });
+} // namespace detail::equal_tuning
 
-        for (auto i = 0U; i < 1001; ++i)
-        {
-            double twelths = i * 1.0 / 12.0 / 1000.0;
-            table_two_to_the[i] = pow(2.0, twelths);
-            table_two_to_the_minus[i] = pow(2.0, -twelths);
-        }
-        initialized = true;
-    }
+/*
+ * The tables are built at compile time and shared by every instance; init() and
+ * initialized remain for existing callers.
+ */
+struct EqualTuningProvider
+{
+    void init() {}
 
     /**
      * note is float offset from note 69 / A440
@@ -76,15 +83,47 @@ struct EqualTuningProvider
         return table_pitch[e] * pow2v;
     }
 
+    // note_to_pitch for four lanes
+    SIMD_M128 note_to_pitch(SIMD_M128 note) const
+    {
+        auto x = SIMD_MM(add_ps)(note, SIMD_MM(set1_ps)(256.f));
+        x = SIMD_MM(min_ps)(SIMD_MM(max_ps)(x, SIMD_MM(set1_ps)(1.e-4f)),
+                            SIMD_MM(set1_ps)(tuning_table_size - (float)1.e-4));
+        auto e = SIMD_MM(cvttps_epi32)(x);
+        auto a = SIMD_MM(sub_ps)(x, SIMD_MM(cvtepi32_ps)(e));
+
+        auto pow2pos = SIMD_MM(mul_ps)(a, SIMD_MM(set1_ps)(1000.f));
+        auto pow2idx = SIMD_MM(min_epi32)(SIMD_MM(cvttps_epi32)(pow2pos), SIMD_MM(set1_epi32)(999));
+        auto pow2frac = SIMD_MM(sub_ps)(pow2pos, SIMD_MM(cvtepi32_ps)(pow2idx));
+
+        SIMD_M128 t0, t1;
+        detail::gatherAdjacent(table_two_to_the.data(), pow2idx, t0, t1);
+        auto pow2v = detail::lerp(pow2frac, t0, t1);
+
+        return SIMD_MM(mul_ps)(detail::gather(table_pitch.data(), e), pow2v);
+    }
+
+    // note and out are 16 byte aligned blocks
+    template <size_t blockSize>
+    void note_to_pitch(const float *__restrict note, float *__restrict out) const
+    {
+        static_assert(!(blockSize & 3), "Block size must be a multiple of four");
+        for (auto i = 0U; i < blockSize; i += 4)
+            SIMD_MM(store_ps)(out + i, note_to_pitch(SIMD_MM(load_ps)(note + i)));
+    }
+
   protected:
-    static constexpr size_t tuning_table_size = 512;
-    float table_pitch alignas(16)[tuning_table_size];
-    float table_pitch_inv alignas(16)[tuning_table_size];
-    float table_note_omega alignas(16)[2][tuning_table_size];
+    static constexpr size_t tuning_table_size = detail::equal_tuning::tuning_table_size;
+    static constexpr const std::array<float, tuning_table_size> &table_pitch{
+        detail::equal_tuning::table_pitch};
+    static constexpr const std::array<float, tuning_table_size> &table_pitch_inv{
+        detail::equal_tuning::table_pitch_inv};
     // 2^0 -> 2^+/-1/12th. See comment in note_to_pitch
-    float table_two_to_the alignas(16)[1001];
-    float table_two_to_the_minus alignas(16)[1001];
-    bool initialized{false};
+    static constexpr const std::array<float, detail::equal_tuning::nInterp> &table_two_to_the{
+        detail::equal_tuning::table_two_to_the};
+    static constexpr const std::array<float, detail::equal_tuning::nInterp>
+        &table_two_to_the_minus{detail::equal_tuning::table_two_to_the_minus};
+    bool initialized{true};
 };
 } // namespace sst::basic_blocks::tables
 
@@ -35,15 +35,31 @@
 #ifndef INCLUDE_SST_BASIC_BLOCKS_TABLES_SIXSINESWAVEPROVIDER_H
 #define INCLUDE_SST_BASIC_BLOCKS_TABLES_SIXSINESWAVEPROVIDER_H
 
+#include <atomic>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
 #include <cstring>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <utility>
+#include <vector>
 
 #include <sst/basic-blocks/simd/setup.h>
 
 namespace sst::basic_blocks::tables
 {
+/*
+ * Each waveform's table (256k at full resolution) is built the first time a provider asks
+ * for it and is then shared by every provider, so constructing one only costs the sine.
+ * Building takes a lock and allocates; if you will change waveform on the audio thread,
+ * call prepareWaveForm (or initializeStatics(true) for all of them) beforehand. Once a
+ * table is built, finding it is a lock free atomic load.
+ *
+ * A half resolution provider uses 2048 points per quadrant, halving the table memory and
+ * cache footprint at the cost of slightly more interpolation error.
+ */
 struct SixSinesWaveProvider
 {
     enum WaveForm
@@ -77,63 +93,90 @@ struct SixSinesWaveProvider
     };
 
     static constexpr size_t nPoints{1 << 12}, nQuadrants{4};
-    inline static double xTable[nQuadrants][nPoints + 1];
-    inline static float quadrantTable[NUM_WAVEFORMS][nQuadrants][nPoints + 1];
-    inline static float dQuadrantTable[NUM_WAVEFORMS][nQuadrants][nPoints + 1];
+    static constexpr size_t nPointsHalfResolution{nPoints >> 1};
 
-    inline static float cubicHermiteCoefficients[nQuadrants][nPoints];
-    inline static float linterpCoefficients[2][nPoints];
+    const SIMD_M128 *simdQuad;  // for each quad it is q, q+1, dq + 1
+    const SIMD_M128 *simdCubic; // it is cq, cq+1, cdq, cd1+1
+
+    SixSinesWaveProvider() : SixSinesWaveProvider(false) {}
+    SixSinesWaveProvider(bool allwaves, bool halfResolution = false)
+        : allWaves(allwaves), halfResolution(halfResolution), resShift(halfResolution ? 1 : 0),
+          upperMask((1 << (14 - resShift)) - 1)
+    {
+        simdCubic = cubicTable();
+        simdQuad = waveTable(SIN, halfResolution);
+    }
 
-    inline static SIMD_M128 simdFullQuad alignas(
-        16)[NUM_WAVEFORMS][nQuadrants * nPoints];           // for each quad it is q, q+1, dq + 1
-    inline static SIMD_M128 simdCubic alignas(16)[nPoints]; // it is cq, cq+1, cdq, cd1+1
-    inline static bool staticsInitialized;
-    inline static bool butOnlyForSine;
+    void setSampleRate(double sr) { frToPhase = (1 << 26) / sr; }
 
-    SIMD_M128 *simdQuad;
+    using waveFunction_t = std::function<std::pair<double, double>(double x, int Q)>;
 
-    SixSinesWaveProvider()
+    /*
+     * Build a waveform's table now, off the audio thread, so setWaveForm doesn't have to.
+     */
+    static void prepareWaveForm(WaveForm wf, bool halfResolution = false)
     {
-        initializeStatics(false);
-        simdQuad = simdFullQuad[0];
+        waveTable(wf, halfResolution);
     }
-    SixSinesWaveProvider(bool allwaves)
+
+    static void initializeStatics(bool allWaves)
     {
-        initializeStatics(allwaves);
-        simdQuad = simdFullQuad[0];
+        cubicTable();
+        for (int wf = 0; wf < (allWaves ? NUM_WAVEFORMS : 1); ++wf)
+            prepareWaveForm((WaveForm)wf);
     }
 
-    void setSampleRate(double sr) { frToPhase = (1 << 26) / sr; }
-    static void fillTable(int WF, std::function<std::pair<double, double>(double x, int Q)> der)
+    static bool isWaveFormBuilt(WaveForm wf, bool halfResolution = false)
     {
-        static constexpr double dxdPhase = 1.0 / (nQuadrants * (nPoints - 1));
-        for (int Q = 0; Q < nQuadrants; ++Q)
-        {
-            for (int i = 0; i < nPoints + 1; ++i)
-            {
-                auto [v, dvdx] = der(xTable[Q][i], Q);
-                quadrantTable[WF][Q][i] = static_cast<float>(v);
-                dQuadrantTable[WF][Q][i] = static_cast<float>(dvdx * dxdPhase);
-            }
-        }
+        return storage().built[halfResolution][wf].load(std::memory_order_acquire);
     }
 
-    static void initializeStatics(bool allWaves)
+    static const SIMD_M128 *waveTable(WaveForm wf, bool halfResolution)
     {
-        if (staticsInitialized)
-            return;
-
-        memset(quadrantTable, 0, sizeof(quadrantTable));
-        memset(dQuadrantTable, 0, sizeof(dQuadrantTable));
+        auto &st = storage();
+        auto &tab = st.tables[halfResolution][wf];
+        if (st.built[halfResolution][wf].load(std::memory_order_acquire))
+            return tab.data;
+
+        std::lock_guard<std::mutex> g(st.buildMutex);
+        if (st.built[halfResolution][wf].load(std::memory_order_relaxed))
+            return tab.data;
+
+        auto pts = halfResolution ? nPointsHalfResolution : nPoints;
+        tab.allocate(nQuadrants * pts);
+        defineWaveForms(wf != SIN, [&](int WF, const waveFunction_t &der) {
+            if (WF == wf)
+                fillTable(tab.data, pts, der);
+        });
+        st.built[halfResolution][wf].store(true, std::memory_order_release);
+        return tab.data;
+    }
 
-        for (int i = 0; i < nPoints + 1; ++i)
+    static void fillTable(SIMD_M128 *into, size_t pts, const waveFunction_t &der)
+    {
+        const double dxdPhase = 1.0 / (nQuadrants * (pts - 1));
+        std::vector<float> v(pts + 1), dv(pts + 1);
+        for (size_t Q = 0; Q < nQuadrants; ++Q)
         {
-            for (int Q = 0; Q < nQuadrants; ++Q)
+            for (size_t i = 0; i < pts + 1; ++i)
             {
-                xTable[Q][i] = (1.0 * i / (nPoints - 1) + Q) * 0.25;
+                auto [val, dvdx] = der((1.0 * i / (pts - 1) + Q) * 0.25, Q);
+                v[i] = static_cast<float>(val);
+                dv[i] = static_cast<float>(dvdx * dxdPhase);
+            }
+            for (size_t i = 0; i < pts; ++i)
+            {
+                float r alignas(16)[4]{v[i], dv[i], v[i + 1], dv[i + 1]};
+                into[pts * Q + i] = SIMD_MM(load_ps)(r);
             }
         }
+    }
 
+    /*
+     * Calls fillTable(WF, der) for each waveform; only SIN unless allWaves.
+     */
+    template <typename F> static void defineWaveForms(bool allWaves, F &&fillTable)
+    {
         static constexpr double twoPi{2.0 * M_PI};
         // Waveform 0: sin(2pix);
         fillTable(WaveForm::SIN, [](double x, int Q) {
@@ -545,61 +588,30 @@ struct SixSinesWaveProvider
                 return std::make_pair(v, dSign * dv);
             });
         }
+    }
 
-        // Fill up interp buffers
-        for (int i = 0; i < nPoints; ++i)
-        {
-            auto t = 1.f * i / (1 << 12);
-
-            auto c0 = 2 * t * t * t - 3 * t * t + 1;
-            auto c1 = t * t * t - 2 * t * t + t;
-            auto c2 = -2 * t * t * t + 3 * t * t;
-            auto c3 = t * t * t - t * t;
-
-            cubicHermiteCoefficients[0][i] = c0;
-            cubicHermiteCoefficients[1][i] = c1;
-            cubicHermiteCoefficients[2][i] = c2;
-            cubicHermiteCoefficients[3][i] = c3;
-
-            linterpCoefficients[0][i] = 1.f - t;
-            linterpCoefficients[1][i] = t;
-        }
-        // Load the SIMD buffers
-        for (int i = 0; i < nPoints; ++i)
-        {
-            for (int WF = 0; WF < NUM_WAVEFORMS; ++WF)
-            {
-                for (int Q = 0; Q < 4; ++Q)
-                {
-                    float r alignas(16)[4];
-                    r[0] = quadrantTable[WF][Q][i];
-                    r[1] = dQuadrantTable[WF][Q][i];
-                    r[2] = quadrantTable[WF][Q][i + 1];
-                    r[3] = dQuadrantTable[WF][Q][i + 1];
-                    simdFullQuad[WF][nPoints * Q + i] = SIMD_MM(load_ps)(r);
-                }
-            }
-
+    static const SIMD_M128 *cubicTable()
+    {
+        static const Table res = []() {
+            Table r;
+            r.allocate(nPoints);
+            for (size_t i = 0; i < nPoints; ++i)
             {
-                float r alignas(16)[4];
-                for (int j = 0; j < 4; ++j)
-                {
-                    r[j] = cubicHermiteCoefficients[j][i];
-                }
-                simdCubic[i] = SIMD_MM(load_ps)(r);
+                auto t = 1.f * i / (1 << 12);
+
+                float c alignas(16)[4];
+                c[0] = 2 * t * t * t - 3 * t * t + 1;
+                c[1] = t * t * t - 2 * t * t + t;
+                c[2] = -2 * t * t * t + 3 * t * t;
+                c[3] = t * t * t - t * t;
+                r.data[i] = SIMD_MM(load_ps)(c);
             }
-        }
-        staticsInitialized = true;
-        butOnlyForSine = !allWaves;
+            return r;
+        }();
+        return res.data;
     }
 
-    void setWaveForm(WaveForm wf)
-    {
-        auto stwf = size_t(wf);
-        if (stwf >= NUM_WAVEFORMS || butOnlyForSine)
-            stwf = 0;
-        simdQuad = simdFullQuad[stwf];
-    }
+    void setWaveForm(WaveForm wf) { simdQuad = tableFor(wf); }
 
     double frToPhase{0};
     inline int32_t dPhase(float fr) const
@@ -609,13 +621,13 @@ struct SixSinesWaveProvider
     }
 
     // phase is 26 bits, 12 of fractional, 12 of position in the table and 2 of quadrant
+    // (at half resolution 13 of fractional, of which we use the top 12, and 11 of position)
     inline float at(const uint32_t ph) const
     {
         static constexpr uint32_t mask{(1 << 12) - 1};
-        static constexpr uint32_t umask{(1 << 14) - 1};
 
-        auto lb = ph & mask;
-        auto ub = (ph >> 12) & umask;
+        auto lb = (ph >> resShift) & mask;
+        auto ub = (ph >> (12 + resShift)) & upperMask;
 
         auto q = simdQuad[ub];
         auto c = simdCubic[lb];
@@ -625,6 +637,120 @@ struct SixSinesWaveProvider
         auto v = SIMD_MM(hadd_ps)(h, h);
         return SIMD_MM(cvtss_f32)(v);
     }
+
+    /*
+     * Look up blockSize phases (a multiple of 4) four at a time. The cubic version gives
+     * exactly what at() would; the linear one ignores the derivatives for a bit more speed.
+     */
+    template <int blockSize> void lookupBlock(const uint32_t *phases, float *out) const
+    {
+        lookupBlockFrom<blockSize, true>(simdQuad, phases, out);
+    }
+    template <int blockSize> void lookupBlockLinear(const uint32_t *phases, float *out) const
+    {
+        lookupBlockFrom<blockSize, false>(simdQuad, phases, out);
+    }
+
+    /*
+     * The same for a given waveform without changing this provider's, for instance several
+     * operators of a voice reading different shapes. It builds the table if need be.
+     */
+    template <int blockSize>
+    void lookupBlock(const uint32_t *phases, WaveForm wf, float *out) const
+    {
+        lookupBlockFrom<blockSize, true>(tableFor(wf), phases, out);
+    }
+
+    /*
+     * nOperators blocks of phases sharing a waveform, as for an FM stack where every operator
+     * is a sine: phases[op] and out[op] are blocks of blockSize.
+     */
+    template <int blockSize>
+    void lookupBlocks(const uint32_t *const *phases, WaveForm wf, float *const *out,
+                      int nOperators) const
+    {
+        auto tab = tableFor(wf);
+        for (int op = 0; op < nOperators; ++op)
+            lookupBlockFrom<blockSize, true>(tab, phases[op], out[op]);
+    }
+
+    bool allWaves{false}, halfResolution{false};
+
+  protected:
+    uint32_t resShift{0}, upperMask{(1 << 14) - 1};
+
+    const SIMD_M128 *tableFor(WaveForm wf) const
+    {
+        auto stwf = size_t(wf);
+        if (stwf >= NUM_WAVEFORMS || !allWaves)
+            stwf = 0;
+        return waveTable((WaveForm)stwf, halfResolution);
+    }
+
+    template <int blockSize, bool cubic>
+    void lookupBlockFrom(const SIMD_M128 *quads, const uint32_t *phases, float *out) const
+    {
+        static_assert(blockSize % 4 == 0, "lookupBlock works four phases at a time");
+        const auto shift = SIMD_MM(cvtsi32_si128)(resShift);
+        const auto ushift = SIMD_MM(cvtsi32_si128)(12 + resShift);
+        const auto lmask = SIMD_MM(set1_epi32)((1 << 12) - 1);
+        const auto umask = SIMD_MM(set1_epi32)(upperMask);
+        const auto tScale = SIMD_MM(set1_ps)(1.f / (1 << 12));
+
+        int32_t lb alignas(16)[4], ub alignas(16)[4];
+        for (int s = 0; s < blockSize; s += 4)
+        {
+            auto ph = SIMD_MM(loadu_si128)((const SIMD_M128I *)(phases + s));
+            auto lbv = SIMD_MM(and_si128)(SIMD_MM(srl_epi32)(ph, shift), lmask);
+            auto ubv = SIMD_MM(and_si128)(SIMD_MM(srl_epi32)(ph, ushift), umask);
+            SIMD_MM(store_si128)((SIMD_M128I *)lb, lbv);
+            SIMD_MM(store_si128)((SIMD_M128I *)ub, ubv);
+
+            auto q0 = quads[ub[0]], q1 = quads[ub[1]], q2 = quads[ub[2]], q3 = quads[ub[3]];
+            if constexpr (cubic)
+            {
+                // each product summed horizontally, in the same order as at()
+                auto r0 = SIMD_MM(mul_ps)(q0, simdCubic[lb[0]]);
+                auto r1 = SIMD_MM(mul_ps)(q1, simdCubic[lb[1]]);
+                auto r2 = SIMD_MM(mul_ps)(q2, simdCubic[lb[2]]);
+                auto r3 = SIMD_MM(mul_ps)(q3, simdCubic[lb[3]]);
+                auto res = SIMD_MM(hadd_ps)(SIMD_MM(hadd_ps)(r0, r1), SIMD_MM(hadd_ps)(r2, r3));
+                SIMD_MM(storeu_ps)(out + s, res);
+            }
+            else
+            {
+                auto a = SIMD_MM(shuffle_ps)(q0, q1, SIMD_MM_SHUFFLE(2, 0, 2, 0));
+                auto b = SIMD_MM(shuffle_ps)(q2, q3, SIMD_MM_SHUFFLE(2, 0, 2, 0));
+                auto v0 = SIMD_MM(shuffle_ps)(a, b, SIMD_MM_SHUFFLE(2, 0, 2, 0));
+                auto v1 = SIMD_MM(shuffle_ps)(a, b, SIMD_MM_SHUFFLE(3, 1, 3, 1));
+                auto t = SIMD_MM(mul_ps)(SIMD_MM(cvtepi32_ps)(lbv), tScale);
+                auto res = SIMD_MM(add_ps)(v0, SIMD_MM(mul_ps)(SIMD_MM(sub_ps)(v1, v0), t));
+                SIMD_MM(storeu_ps)(out + s, res);
+            }
+        }
+    }
+
+    struct Table
+    {
+        SIMD_M128 *data{nullptr};
+        void allocate(size_t n) { data = new SIMD_M128[n]; }
+        Table() = default;
+        Table(Table &&o) noexcept : data(o.data) { o.data = nullptr; }
+        Table(const Table &) = delete;
+        ~Table() { delete[] data; }
+    };
+
+    struct Storage
+    {
+        std::mutex buildMutex;
+        Table tables[2][NUM_WAVEFORMS];
+        std::atomic<bool> built[2][NUM_WAVEFORMS]{};
+    };
+    static Storage &storage()
+    {
+        static Storage st;
+        return st;
+    }
 };
 } // namespace sst::basic_blocks::tables
 #endif // INCLUDE_SST_BASIC_BLOCKS_TABLES_SIXSINESWAVEPROVIDER_H
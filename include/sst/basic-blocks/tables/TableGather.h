@@ -0,0 +1,70 @@
+/*
+ * sst-basic-blocks - an open source library of core audio utilities
+ * built by Surge Synth Team.
+ *
+ * Provides a collection of tools useful on the audio thread for blocks,
+ * modulation, etc... or useful for adapting code to multiple environments.
+ *
+ * Copyright 2023, various authors, as described in the GitHub
+ * transaction log. Parts of this code are derived from similar
+ * functions original in Surge or ShortCircuit.
+ *
+ * sst-basic-blocks is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html.
+ *
+ * A very small number of explicitly chosen header files can also be
+ * used in an MIT/BSD context. Please see the README.md file in this
+ * repo or the comments in the individual files. Only headers with an
+ * explicit mention that they are dual licensed may be copied and reused
+ * outside the GPL3 terms.
+ *
+ * All source in sst-basic-blocks available at
+ * https://github.com/surge-synthesizer/sst-basic-blocks
+ */
+
+#ifndef INCLUDE_SST_BASIC_BLOCKS_TABLES_TABLEGATHER_H
+#define INCLUDE_SST_BASIC_BLOCKS_TABLES_TABLEGATHER_H
+
+#include "sst/basic-blocks/simd/setup.h"
+
+namespace sst::basic_blocks::tables::detail
+{
+/*
+ * SSE has no gather, so the SIMD table lookups spill their lane indices and load the
+ * entries back. gatherAdjacent fetches t[i] and t[i+1] for each lane with one 64 bit load
+ * and deinterleaves, which is what a linearly interpolated lookup needs.
+ */
+inline SIMD_M128 gather(const float *t, SIMD_M128I idx)
+{
+    int i alignas(16)[4];
+    SIMD_MM(store_si128)((SIMD_M128I *)i, idx);
+    return SIMD_MM(set_ps)(t[i[3]], t[i[2]], t[i[1]], t[i[0]]);
+}
+
+inline void gatherAdjacent(const float *t, SIMD_M128I idx, SIMD_M128 &v0, SIMD_M128 &v1)
+{
+    int i alignas(16)[4];
+    SIMD_MM(store_si128)((SIMD_M128I *)i, idx);
+
+    auto p0 = SIMD_MM(loadl_epi64)((const SIMD_M128I *)(t + i[0]));
+    auto p1 = SIMD_MM(loadl_epi64)((const SIMD_M128I *)(t + i[1]));
+    auto p2 = SIMD_MM(loadl_epi64)((const SIMD_M128I *)(t + i[2]));
+    auto p3 = SIMD_MM(loadl_epi64)((const SIMD_M128I *)(t + i[3]));
+
+    auto p01 = SIMD_MM(castsi128_ps)(SIMD_MM(unpacklo_epi64)(p0, p1));
+    auto p23 = SIMD_MM(castsi128_ps)(SIMD_MM(unpacklo_epi64)(p2, p3));
+    v0 = SIMD_MM(shuffle_ps)(p01, p23, SIMD_MM_SHUFFLE(2, 0, 2, 0));
+    v1 = SIMD_MM(shuffle_ps)(p01, p23, SIMD_MM_SHUFFLE(3, 1, 3, 1));
+}
+
+// (1 - f) * v0 + f * v1, in the same order as the scalar lookups so the two agree exactly
+inline SIMD_M128 lerp(SIMD_M128 f, SIMD_M128 v0, SIMD_M128 v1)
+{
+    return SIMD_MM(add_ps)(SIMD_MM(mul_ps)(SIMD_MM(sub_ps)(SIMD_MM(set1_ps)(1.f), f), v0),
+                           SIMD_MM(mul_ps)(f, v1));
+}
+} // namespace sst::basic_blocks::tables::detail
+
+#endif // INCLUDE_SST_BASIC_BLOCKS_TABLES_TABLEGATHER_H
@@ -28,40 +28,46 @@
 #define INCLUDE_SST_BASIC_BLOCKS_TABLES_TWOTOTHEXPROVIDER_H
 
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstdint>
 #include <iostream>
 
+#include "ConstexprMath.h"
+#include "TableGather.h"
+
 namespace sst::basic_blocks::tables
 {
-struct TwoToTheXProvider
+namespace detail::two_to_the_x
 {
-    bool isInit{false};
-    static constexpr int intBase{-15};
-    static constexpr int providerRange{32};
-
-    float baseValue[providerRange]{};
+inline constexpr int intBase{-15};
+inline constexpr int providerRange{32};
+inline constexpr int nInterp{1001};
 
-    static constexpr int nInterp{1001};
-    float table_two_to_the alignas(16)[nInterp];
+alignas(16) inline constexpr std::array<float, providerRange> baseValue =
+    makeTable<providerRange>([](size_t i) { return (float)constexprPow2((int)i + intBase); });
+alignas(16) inline constexpr std::array<float, nInterp> twoToTheFrac = makeTable<nInterp>(
+    [](size_t i) { return (float)constexprPow2(i * 1.0 / (nInterp - 1)); });
+} // namespace detail::two_to_the_x
 
-    void init()
-    {
-        if (isInit)
-            return;
+/*
+ * The tables are generated at compile time and shared by every instance, so there is
+ * nothing to initialize; init() and isInit remain for existing callers.
+ */
+struct TwoToTheXProvider
+{
+    static constexpr bool isInit{true};
+    static constexpr int intBase{detail::two_to_the_x::intBase};
+    static constexpr int providerRange{detail::two_to_the_x::providerRange};
 
-        for (int i = 0; i < providerRange; i++)
-        {
-            baseValue[i] = pow(2.0, i + intBase);
-        }
+    static constexpr const std::array<float, providerRange> &baseValue{
+        detail::two_to_the_x::baseValue};
 
-        for (auto i = 0U; i < nInterp; ++i)
-        {
-            double frac = i * 1.0 / (nInterp - 1);
-            table_two_to_the[i] = pow(2.0, frac);
-        }
+    static constexpr int nInterp{detail::two_to_the_x::nInterp};
+    static constexpr const std::array<float, nInterp> &table_two_to_the{
+        detail::two_to_the_x::twoToTheFrac};
 
-        isInit = true;
-    }
+    void init() {}
 
     float twoToThe(float x) const
     {
@@ -77,6 +83,41 @@ struct TwoToTheXProvider
 
         return baseValue[e] * pow2v;
     }
+
+    /*
+     * Four lanes at once. The integer power of two is built straight into the exponent bits
+     * rather than looked up, so only the fractional table needs a gather.
+     */
+    SIMD_M128 twoToThe(SIMD_M128 x) const
+    {
+        auto xb = SIMD_MM(sub_ps)(x, SIMD_MM(set1_ps)((float)intBase));
+        xb = SIMD_MM(min_ps)(SIMD_MM(max_ps)(xb, SIMD_MM(setzero_ps)()),
+                             SIMD_MM(set1_ps)(providerRange * 1.f));
+        auto e = SIMD_MM(cvttps_epi32)(xb);
+        auto a = SIMD_MM(sub_ps)(xb, SIMD_MM(cvtepi32_ps)(e));
+
+        auto pow2pos = SIMD_MM(mul_ps)(a, SIMD_MM(set1_ps)((float)(nInterp - 1)));
+        auto pow2idx =
+            SIMD_MM(min_epi32)(SIMD_MM(cvttps_epi32)(pow2pos), SIMD_MM(set1_epi32)(nInterp - 2));
+        auto pow2frac = SIMD_MM(sub_ps)(pow2pos, SIMD_MM(cvtepi32_ps)(pow2idx));
+
+        SIMD_M128 t0, t1;
+        detail::gatherAdjacent(table_two_to_the.data(), pow2idx, t0, t1);
+        auto pow2v = detail::lerp(pow2frac, t0, t1);
+
+        auto base = SIMD_MM(castsi128_ps)(
+            SIMD_MM(slli_epi32)(SIMD_MM(add_epi32)(e, SIMD_MM(set1_epi32)(intBase + 127)), 23));
+        return SIMD_MM(mul_ps)(base, pow2v);
+    }
+
+    // x and out are 16 byte aligned blocks
+    template <size_t blockSize>
+    void twoToThe(const float *__restrict x, float *__restrict out) const
+    {
+        static_assert(!(blockSize & 3), "Block size must be a multiple of four");
+        for (auto i = 0U; i < blockSize; i += 4)
+            SIMD_MM(store_ps)(out + i, twoToThe(SIMD_MM(load_ps)(x + i)));
+    }
 };
 } // namespace sst::basic_blocks::tables
 
@@ -147,7 +147,7 @@ struct EllipticBlep {
 	using Coeffs = EllipticBlepCoeffs<Sample>;
 	static constexpr size_t maxBlepOrder = Coeffs::maxIntegrals;
 
-	EllipticBlep(EllipticBlepPoles<Sample> &p) : poles(p)
+	EllipticBlep(const EllipticBlepPoles<Sample> &p) : poles(&p)
 	{
 		reset();
 	}
@@ -164,6 +164,7 @@ struct EllipticBlep {
 		{
 			state[i] = other.state[i];
 		}
+		// repoint rather than copy: the pole data is shared between instances
 		poles = other.poles;
 		reset();
 		return *this;
@@ -184,12 +185,12 @@ struct EllipticBlep {
 
 	/// Future (≤ 1 sample) filter output (as if we called `.step(samplesInFuture)` before `.get()`)
 	Sample get(Sample samplesInFuture) const {
-		Sample tableIndex = samplesInFuture*poles.partialStepCount;
+		Sample tableIndex = samplesInFuture*poles->partialStepCount;
 		size_t intIndex = std::floor(tableIndex);
 		Sample fracIndex = tableIndex - std::floor(tableIndex);
 
-		auto &lowPoles = poles.partialStepPoles[intIndex];
-		auto &highPoles = poles.partialStepPoles[intIndex + 1];
+		auto &lowPoles = poles->partialStepPoles[intIndex];
+		auto &highPoles = poles->partialStepPoles[intIndex + 1];
 
 		Sample sum = 0;
 		for (size_t i = 0; i < count; ++i) {
@@ -201,7 +202,7 @@ struct EllipticBlep {
 
 	void add(Sample amount, size_t blepOrder) {
 		if (blepOrder > maxBlepOrder) return;
-		auto &bc = poles.blepCoeffs[blepOrder];
+		auto &bc = poles->blepCoeffs[blepOrder];
 		for (size_t i = 0; i < count; ++i) {
 			state[i] += amount*bc[i];
 		}
@@ -210,16 +211,16 @@ struct EllipticBlep {
 	void add(Sample amount, size_t blepOrder, Sample samplesInPast) {
 		if (blepOrder > maxBlepOrder) return;
 		
-		auto &bc = poles.blepCoeffs[blepOrder];
+		auto &bc = poles->blepCoeffs[blepOrder];
 
 		assert(samplesInPast >= 0 && samplesInPast <= 1);
-		Sample tableIndex = samplesInPast*poles.partialStepCount;
+		Sample tableIndex = samplesInPast*poles->partialStepCount;
 		size_t intIndex = std::floor(tableIndex);
 		Sample fracIndex = tableIndex - std::floor(tableIndex);
 
 		// move the pulse along in time, the same way as state progresses in .step()
-		auto &lowPoles = poles.partialStepPoles[intIndex];
-		auto &highPoles = poles.partialStepPoles[intIndex + 1];
+		auto &lowPoles = poles->partialStepPoles[intIndex];
+		auto &highPoles = poles->partialStepPoles[intIndex + 1];
 		for (size_t i = 0; i < count; ++i) {
 			Complex lerpPole = lowPoles[i] + (highPoles[i] - lowPoles[i])*fracIndex;
 			state[i] += bc[i]*lerpPole*amount;
@@ -227,24 +228,24 @@ struct EllipticBlep {
 	}
 
 	void step() {
-		const auto &lpoles = poles.partialStepPoles.back();
+		const auto &lpoles = poles->partialStepPoles.back();
 		for (size_t i = 0; i < count; ++i) {
 			state[i] *= lpoles[i];
 		}
 	}
 
 	void step(Sample samples) {
-		Sample tableIndex = samples*poles.partialStepCount;
+		Sample tableIndex = samples*poles->partialStepCount;
 		size_t intIndex = std::floor(tableIndex);
 		Sample fracIndex = tableIndex - std::floor(tableIndex);
 		// We can step forward by > 1 sample
-		while (intIndex >= poles.partialStepCount) {
+		while (intIndex >= poles->partialStepCount) {
 			step();
-			intIndex -= poles.partialStepCount;
+			intIndex -= poles->partialStepCount;
 		}
 
-		auto &lowPoles = poles.partialStepPoles[intIndex];
-		auto &highPoles = poles.partialStepPoles[intIndex + 1];
+		auto &lowPoles = poles->partialStepPoles[intIndex];
+		auto &highPoles = poles->partialStepPoles[intIndex + 1];
 
 		for (size_t i = 0; i < count; ++i) {
 			Complex lerpPole = lowPoles[i] + (highPoles[i] - lowPoles[i])*fracIndex;
@@ -258,7 +259,7 @@ private:
 
 	using Array = std::array<Complex, count>;
 	Array state;
-	EllipticBlepPoles<Sample> &poles;
+	const EllipticBlepPoles<Sample> *poles;
 };
 
 // Allpass which makes the Elliptic BLEP filter approximately linear-phase
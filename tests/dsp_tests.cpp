@@ -29,6 +29,10 @@
 #include <cmath>
 #include <array>
 #include <iostream>
+#include <tuple>
+#include <vector>
+#include <memory>
+#include <thread>
 
 #include "sst/basic-blocks/dsp/BlockInterpolators.h"
 #include "sst/basic-blocks/dsp/QuadratureOscillators.h"
@@ -41,6 +45,10 @@
 #include "sst/basic-blocks/mechanics/block-ops.h"
 #include "sst/basic-blocks/tables/SincTableProvider.h"
 #include "sst/basic-blocks/dsp/SSESincDelayLine.h"
+#include "sst/basic-blocks/dsp/MipMappedSampleReader.h"
+#include "sst/basic-blocks/dsp/EllipticBlepOscillators.h"
+#include "sst/basic-blocks/dsp/DPWSawPulseOscillator.h"
+#include "sst/basic-blocks/dsp/WavetableOscillator.h"
 #include "sst/basic-blocks/dsp/OnePoles.h"
 #include "sst/basic-blocks/dsp/FollowSlewAndSmooth.h"
 #include "sst/basic-blocks/dsp/OscillatorDriftUnisonCharacter.h"
@@ -300,6 +308,98 @@ TEST_CASE("Quadrature Oscillator", "[dsp]")
     }
 }
 
+TEST_CASE("Quadrature Oscillator Bank", "[dsp]")
+{
+    static constexpr int bs{32};
+    using bank_t = sst::basic_blocks::dsp::QuadratureOscillatorBank<16, bs>;
+    auto omegaFor = [](int i) { return 0.013f * (i + 1) * (i + 1); };
+    auto ampFor = [](int i) { return 1.f / (i + 1); };
+
+    SECTION("Sum Of Partials")
+    {
+        auto bank = std::make_unique<bank_t>();
+        for (int i = 0; i < 16; ++i)
+            bank->setPartial(i, omegaFor(i), ampFor(i));
+        // 0.013 * 16^2 is past nyquist so that partial is silent
+        bank->setActivePartials(16);
+
+        float out[bs];
+        for (int b = 0; b < 100; ++b)
+        {
+            bank->processBlock(out);
+            for (int s = 0; s < bs; ++s)
+            {
+                auto n = b * bs + s + 1;
+                double ex{0};
+                for (int i = 0; i < 15; ++i)
+                    ex += ampFor(i) * std::sin(n * (double)omegaFor(i));
+                INFO("Sample " << n);
+                REQUIRE(out[s] == Approx(ex).margin(5e-3));
+            }
+        }
+    }
+
+    SECTION("Amplitude Is Stable Under Frequency Changes")
+    {
+        auto bank = std::make_unique<bank_t>();
+        bank->setActivePartials(4);
+        float out[bs];
+        for (int b = 0; b < 5000; ++b)
+        {
+            bank->setPartial(0, 0.05f + 0.04f * std::sin(b * 0.37), 1.f);
+            bank->processBlock(out);
+        }
+        bank->setPartial(0, 0.05f, 1.f);
+        float mx{0};
+        for (int b = 0; b < 20; ++b)
+        {
+            bank->processBlock(out);
+            for (int s = 0; s < bs; ++s)
+                mx = std::max(mx, std::fabs(out[s]));
+        }
+        REQUIRE(mx == Approx(1.f).margin(2e-3));
+    }
+
+    SECTION("Audio Rate FM")
+    {
+        auto bank = std::make_unique<bank_t>(), ref = std::make_unique<bank_t>();
+        bank->setActivePartials(4);
+        ref->setActivePartials(4);
+        for (int i = 0; i < 4; ++i)
+        {
+            bank->setPartial(i, omegaFor(i), ampFor(i));
+            ref->setPartial(i, 2 * omegaFor(i), ampFor(i));
+        }
+
+        float mul[bs], out[bs], rout[bs];
+        std::fill(mul, mul + bs, 2.f);
+        for (int b = 0; b < 50; ++b)
+        {
+            bank->processBlockFM(mul, out);
+            ref->processBlock(rout);
+            for (int s = 0; s < bs; ++s)
+                REQUIRE(out[s] == Approx(rout[s]).margin(1e-4));
+        }
+
+        // modulate hard and the amplitude should still hold
+        bank->setActivePartials(4);
+        bank->setPartial(1, 0, 0);
+        bank->setPartial(2, 0, 0);
+        bank->setPartial(3, 0, 0);
+        float mx{0};
+        for (int b = 0; b < 500; ++b)
+        {
+            for (int s = 0; s < bs; ++s)
+                mul[s] = 1 + 0.9 * std::sin((b * bs + s) * 0.031);
+            bank->processBlockFM(mul, out);
+            if (b > 400)
+                for (int s = 0; s < bs; ++s)
+                    mx = std::max(mx, std::fabs(out[s]));
+        }
+        REQUIRE(mx == Approx(1.f).margin(2e-3));
+    }
+}
+
 TEST_CASE("Surge Quadrature Oscillator", "[dsp]")
 {
     for (const auto omega : {0.04, 0.12, 0.43, 0.97})
@@ -420,6 +520,232 @@ TEST_CASE("LanczosResampler", "[dsp]")
     }
 }
 
+TEST_CASE("LanczosResampler Block Reads", "[dsp]")
+{
+    using lr_t = sst::basic_blocks::dsp::LanczosResampler<32>;
+    lr_t block(48000, 44100), scalar(48000, 44100);
+    for (int i = 0; i < 3000; ++i)
+    {
+        auto L = (float)std::sin(i * 0.021);
+        auto R = (float)std::cos(i * 0.0137);
+        block.push(L, R);
+        scalar.push(L, R);
+    }
+
+    float bL alignas(16)[64], bR alignas(16)[64], sL[64], sR[64];
+    int total{0};
+    for (int blk = 0; blk < 40; ++blk)
+    {
+        block.populateNextBlockSize(bL, bR);
+
+        double r0 = scalar.phaseI - scalar.phaseO;
+        for (int i = 0; i < 32; ++i)
+            scalar.read(r0 - i * scalar.dPhaseO, sL[i], sR[i]);
+        scalar.advanceReadPointer(32);
+
+        for (int i = 0; i < 32; ++i)
+        {
+            REQUIRE(bL[i] == Approx(sL[i]).margin(1e-6));
+            REQUIRE(bR[i] == Approx(sR[i]).margin(1e-6));
+        }
+    }
+
+    // and populateNext, with a count which isn't a multiple of 4
+    lr_t pop(48000, 44100), ref(48000, 44100);
+    for (int i = 0; i < 3000; ++i)
+    {
+        auto L = (float)std::sin(i * 0.021);
+        auto R = (float)std::cos(i * 0.0137);
+        pop.push(L, R);
+        ref.push(L, R);
+    }
+    int gen;
+    while ((gen = pop.populateNext(bL, bR, 63)) > 0)
+    {
+        for (int i = 0; i < gen; ++i)
+        {
+            REQUIRE(ref.phaseI - ref.phaseO > ref.A + 1);
+            ref.read(ref.phaseI - ref.phaseO, sL[i], sR[i]);
+            ref.advanceReadPointer(1);
+            REQUIRE(bL[i] == Approx(sL[i]).margin(1e-6));
+            REQUIRE(bR[i] == Approx(sR[i]).margin(1e-6));
+        }
+        total += gen;
+    }
+    REQUIRE(!(ref.phaseI - ref.phaseO > ref.A + 1));
+    REQUIRE(total > 2500);
+}
+
+template <int order> void lanczosOrderSineError(double &err)
+{
+    sst::basic_blocks::dsp::LanczosResampler<32, order> lr(48000, 44100);
+    for (int i = 0; i < 2000; ++i)
+        lr.push(std::sin(i * 0.05), std::cos(i * 0.05));
+
+    err = 0;
+    for (int i = 0; i < 100; ++i)
+    {
+        double xBack = 100.0 + i * 0.37;
+        float L, R;
+        lr.read(xBack, L, R);
+        // xBack = 1 is the most recent sample pushed
+        double p = 1999 - xBack;
+        err = std::max(err, std::fabs(L - std::sin(p * 0.05)));
+        err = std::max(err, std::fabs(R - std::cos(p * 0.05)));
+    }
+}
+
+TEST_CASE("LanczosResampler Order", "[dsp]")
+{
+    namespace dsp = sst::basic_blocks::dsp;
+    double e2, e3, e4, e8;
+    lanczosOrderSineError<2>(e2);
+    lanczosOrderSineError<3>(e3);
+    lanczosOrderSineError<4>(e4);
+    lanczosOrderSineError<8>(e8);
+    INFO(e2 << " " << e3 << " " << e4 << " " << e8);
+    REQUIRE(e2 < 3e-2);
+    REQUIRE(e3 < 1e-2);
+    REQUIRE(e4 < 5e-3);
+    REQUIRE(e8 < 1e-3);
+    // higher orders are flatter in the passband
+    REQUIRE(e8 < e4);
+    REQUIRE(e4 < e3);
+    REQUIRE(e3 < e2);
+
+    // tables depend only on the order and are shared
+    dsp::LanczosResampler<16> a(48000, 96000);
+    dsp::LanczosResampler<64> b(44100, 48000);
+    dsp::MultiChannelLanczosResampler<32, 6> c(48000, 44100);
+    REQUIRE(a.tables == b.tables);
+    REQUIRE((const void *)a.tables == (const void *)c.tables);
+    dsp::LanczosResampler<16, 3> d(48000, 96000);
+    REQUIRE((const void *)a.tables != (const void *)d.tables);
+}
+
+template <int factor> void lanczosPolyphaseRoundTrip()
+{
+    namespace dsp = sst::basic_blocks::dsp;
+    static constexpr int bs{32};
+    dsp::LanczosPolyphaseUpsampler<factor, bs> up;
+    dsp::LanczosPolyphaseDownsampler<factor, bs> down;
+
+    float inL[bs], inR[bs], osL[bs * factor], osR[bs * factor], outL[bs], outR[bs];
+    std::vector<float> allIn, allOS, allOut;
+    for (int blk = 0; blk < 40; ++blk)
+    {
+        for (int i = 0; i < bs; ++i)
+        {
+            auto n = blk * bs + i;
+            inL[i] = std::sin(n * 0.05);
+            inR[i] = -inL[i];
+            allIn.push_back(inL[i]);
+        }
+        up.process(inL, inR, osL, osR);
+        down.process(osL, osR, outL, outR);
+        for (int i = 0; i < bs * factor; ++i)
+        {
+            REQUIRE(osR[i] == Approx(-osL[i]).margin(1e-6));
+            allOS.push_back(osL[i]);
+        }
+        for (int i = 0; i < bs; ++i)
+            allOut.push_back(outL[i]);
+    }
+
+    // The upsampled stream is the input delayed by A, exactly so on the zero phase
+    auto A = decltype(up)::A;
+    for (size_t n = A + 200; n < allIn.size(); ++n)
+    {
+        REQUIRE(allOS[n * factor] == Approx(allIn[n - A]).margin(1e-6));
+        for (int p = 1; p < factor; ++p)
+        {
+            auto x = n - A + 1.0 * p / factor;
+            REQUIRE(allOS[n * factor + p] == Approx(std::sin(x * 0.05)).margin(5e-3));
+        }
+    }
+
+    // and the round trip is the input delayed by a further A - 1
+    for (size_t n = 2 * A + 200; n < allIn.size(); ++n)
+    {
+        auto x = n - 2.0 * A + 1;
+        REQUIRE(allOut[n] == Approx(std::sin(x * 0.05)).margin(1e-2));
+    }
+}
+
+TEST_CASE("LanczosPolyphase Oversampling", "[dsp]")
+{
+    SECTION("2x") { lanczosPolyphaseRoundTrip<2>(); }
+    SECTION("4x") { lanczosPolyphaseRoundTrip<4>(); }
+
+    SECTION("Downsampling Band Limits")
+    {
+        namespace dsp = sst::basic_blocks::dsp;
+        static constexpr int bs{32};
+        // a tone at 0.75 of the oversampled nyquist folds back without the filter
+        for (auto [w, lo, hi] : {std::tuple{0.1 * M_PI, 0.9, 1.05}, {0.75 * M_PI, 0.0, 0.05}})
+        {
+            dsp::LanczosPolyphaseDownsampler<2, bs> down;
+            float inL[bs * 2], inR[bs * 2], outL[bs], outR[bs];
+            float mx{0};
+            for (int blk = 0; blk < 40; ++blk)
+            {
+                for (int i = 0; i < bs * 2; ++i)
+                {
+                    inL[i] = std::sin((blk * bs * 2 + i) * w);
+                    inR[i] = inL[i];
+                }
+                down.process(inL, inR, outL, outR);
+                if (blk > 2)
+                    for (int i = 0; i < bs; ++i)
+                        mx = std::max(mx, std::fabs(outL[i]));
+            }
+            INFO("w=" << w << " peak=" << mx);
+            REQUIRE(mx >= lo);
+            REQUIRE(mx <= hi);
+        }
+    }
+}
+
+TEST_CASE("MultiChannelLanczosResampler", "[dsp]")
+{
+    static constexpr int nc{6};
+    sst::basic_blocks::dsp::LanczosResampler<32> st0(48000, 44100), st1(48000, 44100),
+        st2(48000, 44100);
+    sst::basic_blocks::dsp::MultiChannelLanczosResampler<32, nc> mc(48000, 44100);
+
+    auto sig = [](int c, int i) { return (float)std::sin(i * 0.013 * (c + 1) + c); };
+    for (int i = 0; i < 2000; ++i)
+    {
+        float frame[nc];
+        for (int c = 0; c < nc; ++c)
+            frame[c] = sig(c, i);
+        mc.push(frame);
+        st0.push(frame[0], frame[1]);
+        st1.push(frame[2], frame[3]);
+        st2.push(frame[4], frame[5]);
+    }
+
+    float out alignas(16)[nc][64];
+    float *outP[nc];
+    for (int c = 0; c < nc; ++c)
+        outP[c] = out[c];
+    float stOut alignas(16)[nc][64];
+
+    size_t total{0};
+    size_t gen;
+    while ((gen = mc.populateNext(outP, 64)) > 0)
+    {
+        REQUIRE(st0.populateNext(stOut[0], stOut[1], 64) == gen);
+        REQUIRE(st1.populateNext(stOut[2], stOut[3], 64) == gen);
+        REQUIRE(st2.populateNext(stOut[4], stOut[5], 64) == gen);
+        for (int c = 0; c < nc; ++c)
+            for (size_t i = 0; i < gen; ++i)
+                REQUIRE(out[c][i] == Approx(stOut[c][i]).margin(1e-5));
+        total += gen;
+    }
+    REQUIRE(total > 1500);
+}
+
 TEST_CASE("Check FastMath Functions", "[dsp]")
 {
     SECTION("Clamp to -PI,PI")
@@ -718,6 +1044,51 @@ TEST_CASE("SoftClip Block", "[dsp]")
     }
 }
 
+template <bool hw> void quadDelayLineMatchesSingleLines()
+{
+    namespace dsp = sst::basic_blocks::dsp;
+    static constexpr int combSize{4096};
+    sst::basic_blocks::tables::SurgeSincTableProvider st;
+    auto quad = std::make_unique<dsp::quadDelayLine<combSize * 4, hw>>(st);
+    std::vector<std::unique_ptr<dsp::SSESincDelayLine<combSize>>> singles;
+    for (int l = 0; l < 4; ++l)
+        singles.push_back(std::make_unique<dsp::SSESincDelayLine<combSize>>(st));
+
+    auto sig = [](int l, int i) { return (float)std::sin(i * 0.013 * (l + 1) + l); };
+    for (int i = 0; i < 3 * combSize; ++i)
+    {
+        quad->write(SIMD_MM(setr_ps)(sig(0, i), sig(1, i), sig(2, i), sig(3, i)));
+        for (int l = 0; l < 4; ++l)
+            singles[l]->write(sig(l, i));
+
+        if (i > combSize && i % 17 == 0)
+        {
+            float delays alignas(16)[4]{8.3f, 173.7f, 1024.f, 3000.55f};
+            for (auto &d : delays)
+                d += (i % 100) * 0.31f;
+
+            float lin alignas(16)[4], cub alignas(16)[4], snc alignas(16)[4];
+            auto dv = SIMD_MM(load_ps)(delays);
+            SIMD_MM(store_ps)(lin, quad->read(dv));
+            SIMD_MM(store_ps)(cub, quad->readCubic(dv));
+            SIMD_MM(store_ps)(snc, quad->readSinc(dv));
+            for (int l = 0; l < 4; ++l)
+            {
+                INFO("Iteration " << i << " line " << l);
+                REQUIRE(lin[l] == Approx(singles[l]->readLinear(delays[l])).margin(1e-6));
+                REQUIRE(cub[l] == Approx(singles[l]->readCubic(delays[l])).margin(1e-6));
+                REQUIRE(snc[l] == Approx(singles[l]->read(delays[l])).margin(1e-6));
+            }
+        }
+    }
+}
+
+TEST_CASE("Quad Delay Line", "[dsp]")
+{
+    SECTION("Default Gather") { quadDelayLineMatchesSingleLines<true>(); }
+    SECTION("Scalar Gather") { quadDelayLineMatchesSingleLines<false>(); }
+}
+
 TEST_CASE("Sinc Delay Line", "[dsp]")
 { // This requires SurgeStorate to initialize its tables.
     // Easiest way to do that is to just make a surge
@@ -790,6 +1161,87 @@ TEST_CASE("Sinc Delay Line", "[dsp]")
         }
     }
 
+    SECTION("Multi Tap Reads")
+    {
+        sst::basic_blocks::tables::SurgeSincTableProvider st;
+        sst::basic_blocks::dsp::SSESincDelayLine<4096> dl4096(st.sinctable);
+
+        for (int i = 0; i < 10000; ++i)
+            dl4096.write(std::sin(i * 0.0123) + 0.3 * std::sin(i * 0.173));
+
+        // a handful of chorus like taps, including a count which isn't a multiple of four
+        float delays[7]{12.3, 174.3, 256.0, 1732.4, 3987.2, 14.99, 1000.5};
+        float multi[7];
+        for (int i = 0; i < 2000; ++i)
+        {
+            INFO("Iteration " << i);
+            dl4096.readN(delays, multi, 7);
+            for (int t = 0; t < 7; ++t)
+                REQUIRE(multi[t] == Approx(dl4096.read(delays[t])).margin(1e-6));
+
+            dl4096.write(std::sin((10000 + i) * 0.0123));
+            for (auto &d : delays)
+                d += 0.037f;
+        }
+    }
+
+    SECTION("Block Process")
+    {
+        sst::basic_blocks::tables::SurgeSincTableProvider st;
+        sst::basic_blocks::dsp::SSESincDelayLine<4096> blk(st.sinctable), ref(st.sinctable);
+
+        static constexpr int bs{32};
+        float in[bs], delay[bs], out[bs];
+        int n{0};
+        for (int b = 0; b < 500; ++b)
+        {
+            for (int i = 0; i < bs; ++i)
+            {
+                in[i] = std::sin(n * 0.0123) + 0.3 * std::sin(n * 0.173);
+                // a chorus like sweep, down to the shortest supported delay
+                delay[i] = 6.f + 400.f * (1 + std::sin(n * 0.0007));
+                n++;
+            }
+            blk.process<bs>(in, delay, out);
+            for (int i = 0; i < bs; ++i)
+            {
+                INFO("Block " << b << " sample " << i);
+                ref.write(in[i]);
+                REQUIRE(out[i] == Approx(ref.read(delay[i])).margin(1e-6));
+            }
+        }
+    }
+
+    SECTION("Block Process At Long Delays")
+    {
+        using stp = sst::basic_blocks::tables::SurgeSincTableProvider;
+        stp st;
+        static constexpr int comb{4096};
+        sst::basic_blocks::dsp::SSESincDelayLine<comb> blk(st.sinctable), ref(st.sinctable);
+
+        // a large block must not shorten the usable range by more than the documented 3
+        static constexpr int bs{256};
+        static constexpr float maxDelay{comb - stp::FIRipol_N - 3.f - 1.f};
+        float in[bs], delay[bs], out[bs];
+        int n{0};
+        for (int b = 0; b < 100; ++b)
+        {
+            for (int i = 0; i < bs; ++i)
+            {
+                in[i] = std::sin(n * 0.0123) + 0.3 * std::sin(n * 0.173);
+                delay[i] = maxDelay - 50.f * (1 + std::sin(n * 0.003));
+                n++;
+            }
+            blk.process<bs>(in, delay, out);
+            for (int i = 0; i < bs; ++i)
+            {
+                INFO("Block " << b << " sample " << i << " delay " << delay[i]);
+                ref.write(in[i]);
+                REQUIRE(out[i] == Approx(ref.read(delay[i])).margin(1e-6));
+            }
+        }
+    }
+
 #if 0
 // This prints output I used for debugging
     SECTION( "Generate Output" )
@@ -906,6 +1358,341 @@ TEST_CASE("Sinc Interpolator", "[dsp]")
     }
 }
 
+template <uint32_t stride> void sincInterpolatorReadAllMatchesChannels()
+{
+    static constexpr size_t np{1000},
+        off{sst::basic_blocks::tables::SurgeSincTableProvider::FIRipol_N};
+    std::vector<float> buffer(stride * (np + 2 * off), 0.f);
+    for (size_t i = 0; i < np; ++i)
+        for (uint32_t c = 0; c < stride; ++c)
+            buffer[stride * (i + off) + c] = std::sin(i * 0.013 * (c + 1) + c);
+
+    sst::basic_blocks::tables::SurgeSincTableProvider st;
+    sst::basic_blocks::dsp::SSESincInterpolater<stride> si(st, buffer.data(), np + 2 * off);
+
+    float all[stride];
+    for (size_t i = 10; i < np - 10; ++i)
+    {
+        for (auto frac : {0.0, 0.13, 0.5, 0.77})
+        {
+            si.readAll(i + frac, all);
+            for (uint32_t c = 0; c < stride; ++c)
+            {
+                sst::basic_blocks::dsp::SSESincInterpolater<stride> ci(st, buffer.data() + c,
+                                                                      np + 2 * off);
+                INFO("i=" << i << " frac=" << frac << " channel=" << c);
+                REQUIRE(all[c] == Approx(ci.read(i + frac)).margin(1e-6));
+            }
+        }
+    }
+}
+
+TEST_CASE("Sinc Interpolator Read All Channels", "[dsp]")
+{
+    SECTION("Mono") { sincInterpolatorReadAllMatchesChannels<1>(); }
+    SECTION("Stereo") { sincInterpolatorReadAllMatchesChannels<2>(); }
+    SECTION("Three") { sincInterpolatorReadAllMatchesChannels<3>(); }
+    SECTION("Four") { sincInterpolatorReadAllMatchesChannels<4>(); }
+    SECTION("Eight") { sincInterpolatorReadAllMatchesChannels<8>(); }
+}
+
+TEST_CASE("MipMappedSampleReader", "[dsp]")
+{
+    namespace dsp = sst::basic_blocks::dsp;
+    sst::basic_blocks::tables::SurgeSincTableProvider st;
+    static constexpr size_t np{40000};
+
+    // peak of the playback at ratio through a tone of w cycles per sample
+    auto playedPeak = [&](float w, float ratio) {
+        std::vector<float> smp(np);
+        for (size_t i = 0; i < np; ++i)
+            smp[i] = std::sin(2.0 * M_PI * w * i);
+        dsp::MipMappedSampleReader<1> rd(st);
+        rd.build(smp.data(), np);
+        float mx{0};
+        for (float p = 1000; p < np - 1000; p += ratio)
+            mx = std::max(mx, std::fabs(rd.read(p, ratio)));
+        return mx;
+    };
+
+    SECTION("Levels")
+    {
+        std::vector<float> smp(np, 0.f);
+        dsp::MipMappedSampleReader<1> rd(st);
+        rd.build(smp.data(), np, 5);
+        REQUIRE(rd.numLevels() == 5);
+        REQUIRE(rd.framesAt(0) == np);
+        REQUIRE(rd.framesAt(4) == np / 16);
+
+        dsp::MipMappedSampleReader<1> shortRd(st);
+        shortRd.build(smp.data(), 100);
+        REQUIRE(shortRd.numLevels() == 4);
+    }
+
+    SECTION("Not Copyable But Movable")
+    {
+        using rd_t = dsp::MipMappedSampleReader<1>;
+        static_assert(!std::is_copy_constructible_v<rd_t>);
+        static_assert(!std::is_copy_assignable_v<rd_t>);
+        static_assert(std::is_move_constructible_v<rd_t>);
+
+        std::vector<float> smp(np);
+        for (size_t i = 0; i < np; ++i)
+            smp[i] = std::sin(i * 0.031) + 0.2 * std::sin(i * 0.77);
+        auto src = std::make_unique<rd_t>(st);
+        src->build(smp.data(), np);
+        std::vector<float> before;
+        for (float p = 1000; p < 2000; p += 3.7)
+            before.push_back(src->read(p, 2.3f));
+
+        rd_t moved(std::move(*src));
+        src.reset();
+        size_t i{0};
+        for (float p = 1000; p < 2000; p += 3.7)
+            REQUIRE(moved.read(p, 2.3f) == before[i++]);
+    }
+
+    SECTION("Unpitched Playback Is The Sinc Read")
+    {
+        std::vector<float> smp(np + 2 * st.FIRipol_N, 0.f);
+        for (size_t i = 0; i < np; ++i)
+            smp[i + st.FIRipol_N] = std::sin(i * 0.031) + 0.2 * std::sin(i * 0.77);
+        dsp::MipMappedSampleReader<1> rd(st);
+        rd.build(smp.data() + st.FIRipol_N, np);
+        dsp::SSESincInterpolater<1> si(st, smp.data(), np + 2 * st.FIRipol_N);
+        for (float p = 100; p < 1000; p += 0.73)
+            REQUIRE(rd.read(p, 1.f) == Approx(si.read(p)).margin(1e-6));
+    }
+
+    SECTION("Pitched Up Playback Is Band Limited")
+    {
+        // a tone which is well under nyquist for the original...
+        REQUIRE(playedPeak(0.15, 1.f) > 0.8);
+        // ...but would alias at higher ratios is gone
+        REQUIRE(playedPeak(0.15, 4.f) < 0.01);
+        REQUIRE(playedPeak(0.15, 5.5f) < 0.01);
+        REQUIRE(playedPeak(0.2, 3.f) < 0.01);
+        // where a low tone survives transposition
+        REQUIRE(playedPeak(0.02, 4.f) > 0.95);
+        REQUIRE(playedPeak(0.02, 5.5f) > 0.85);
+    }
+
+    SECTION("Interleaved Stereo")
+    {
+        std::vector<float> smp(2 * np);
+        for (size_t i = 0; i < np; ++i)
+        {
+            smp[2 * i] = std::sin(2.0 * M_PI * 0.01 * i);
+            smp[2 * i + 1] = std::sin(2.0 * M_PI * 0.15 * i);
+        }
+        dsp::MipMappedSampleReader<2> rd(st);
+        rd.build(smp.data(), np);
+        float mxL{0}, mxR{0};
+        for (float p = 1000; p < np - 1000; p += 4.f)
+        {
+            float out[2];
+            rd.readAll(p, 4.f, out);
+            REQUIRE(out[0] == Approx(std::sin(2.0 * M_PI * 0.01 * p)).margin(0.05));
+            mxL = std::max(mxL, std::fabs(out[0]));
+            mxR = std::max(mxR, std::fabs(out[1]));
+        }
+        REQUIRE(mxL == Approx(1.f).margin(0.05));
+        REQUIRE(mxR < 0.02);
+    }
+}
+
+template <typename Impl, int N, typename Setup> void ebUnisonMatchesVoices(Setup &&setup)
+{
+    namespace dsp = sst::basic_blocks::dsp;
+    auto bank = std::make_unique<dsp::EBUnisonBank<Impl, N>>();
+    std::vector<std::unique_ptr<Impl>> lone;
+
+    bank->setSampleRate(48000);
+    for (int v = 0; v < N; ++v)
+    {
+        lone.push_back(std::make_unique<Impl>());
+        lone[v]->setSampleRate(48000);
+        setup(*lone[v], v);
+        setup(bank->voices[v], v);
+    }
+
+    float out[N];
+    for (int s = 0; s < 20000; ++s)
+    {
+        if (s == 10000)
+        {
+            // retune mid stream so the smoothers are live
+            for (int v = 0; v < N; ++v)
+            {
+                lone[v]->setFrequency(2000 + 97 * v);
+                bank->voices[v].setFrequency(2000 + 97 * v);
+            }
+        }
+        bank->step(out);
+        for (int v = 0; v < N; ++v)
+        {
+            INFO("Sample " << s << " voice " << v);
+            REQUIRE(out[v] == Approx(lone[v]->step()).margin(1e-5));
+        }
+    }
+}
+
+TEST_CASE("EBUnisonBank", "[dsp]")
+{
+    namespace dsp = sst::basic_blocks::dsp;
+    dsp::prepareEBOscillators(48000);
+    using ss = dsp::BlockInterpSmoothingStrategy<8>;
+    auto detune = [](auto &osc, int v) {
+        osc.setFrequency(220 * std::pow(2.0, (v - 3) * 0.013));
+        osc.setInitialPhase(0.137f * v);
+    };
+
+    SECTION("Saw, 7 voices") { ebUnisonMatchesVoices<dsp::EBSaw<>, 7>(detune); }
+    SECTION("Synced Saw, 9 voices")
+    {
+        ebUnisonMatchesVoices<dsp::EBSaw<ss>, 9>([&](auto &osc, int v) {
+            detune(osc, v);
+            osc.setSyncRatio(1.7);
+        });
+    }
+    SECTION("Pulse, 8 voices")
+    {
+        ebUnisonMatchesVoices<dsp::EBPulse<>, 8>([&](auto &osc, int v) {
+            detune(osc, v);
+            osc.setWidth(0.2 + 0.05 * v);
+        });
+    }
+    SECTION("Tri, 3 voices") { ebUnisonMatchesVoices<dsp::EBTri<>, 3>(detune); }
+}
+
+template <typename Osc, typename Setup>
+void ebFillBlockMatchesStep(Setup setup, float tolerance)
+{
+    static constexpr int bs{32};
+    Osc a, b;
+    for (auto *o : {&a, &b})
+    {
+        o->setSampleRate(48000);
+        setup(*o, 0);
+    }
+
+    float blk[bs];
+    for (int block = 0; block < 300; ++block)
+    {
+        // hold, glide to a new pitch, hold again
+        if (block == 100 || block == 101)
+        {
+            setup(a, block);
+            setup(b, block);
+        }
+        a.template fillBlock<bs>(blk);
+        for (int i = 0; i < bs; ++i)
+        {
+            INFO("block " << block << " sample " << i);
+            REQUIRE(blk[i] == Approx(b.step()).margin(tolerance));
+        }
+    }
+}
+
+TEST_CASE("EB Fill Block", "[dsp]")
+{
+    namespace dsp = sst::basic_blocks::dsp;
+    dsp::prepareEBOscillators(48000);
+    using ns = dsp::NoSmoothingStrategy;
+    using bi = dsp::BlockInterpSmoothingStrategy<32>;
+
+    auto pitch = [](auto &osc, int block) {
+        osc.setFrequency(block < 100 ? 220 : 331.7);
+        osc.setSyncRatio(1.6);
+    };
+    auto pulse = [&](auto &osc, int block) {
+        pitch(osc, block);
+        osc.setWidth(block < 100 ? 0.3 : 0.45);
+    };
+
+    SECTION("Exact Without Smoothing")
+    {
+        ebFillBlockMatchesStep<dsp::EBSaw<ns>>(pitch, 0);
+        ebFillBlockMatchesStep<dsp::EBTri<ns>>(pitch, 0);
+        ebFillBlockMatchesStep<dsp::EBApproxSin<ns>>(pitch, 0);
+        ebFillBlockMatchesStep<dsp::EBPulse<ns>>(pulse, 0);
+    }
+    SECTION("Block Interpolated")
+    {
+        ebFillBlockMatchesStep<dsp::EBSaw<bi>>(pitch, 0);
+        ebFillBlockMatchesStep<dsp::EBPulse<bi>>(pulse, 0);
+    }
+    SECTION("Lagged")
+    {
+        // the lag snaps to its target once settled, which is a tiny pitch change
+        ebFillBlockMatchesStep<dsp::EBSaw<>>(pitch, 1e-3);
+        ebFillBlockMatchesStep<dsp::EBTri<>>(pitch, 1e-3);
+        ebFillBlockMatchesStep<dsp::EBPulse<>>(pulse, 1e-3);
+    }
+}
+
+TEST_CASE("EB Pole Cache", "[dsp]")
+{
+    namespace dsp = sst::basic_blocks::dsp;
+    using ch = dsp::CoeffHolder;
+
+    SECTION("Standard Rates Are Stable")
+    {
+        auto *p = &ch::getPoleDataForSampleRate(48000);
+        REQUIRE(p == &ch::getPoleDataForSampleRate(48000.0));
+        REQUIRE(p != &ch::getPoleDataForSampleRate(96000));
+        REQUIRE(&ch::getPoleDataForSampleRate(44100) == &ch::getPoleDataForSampleRate(44100));
+    }
+
+    SECTION("Set Sample Rate Leaves Shared Tables Alone")
+    {
+        // assigning the blep for a new rate used to copy that rate's poles over the 44.1k table
+        const auto &p44 = ch::getPoleDataForSampleRate(44100);
+        auto stepPoles = p44.partialStepPoles;
+        auto coeffs = p44.blepCoeffs;
+        REQUIRE(p44.partialStepPoles[10][0] !=
+                ch::getPoleDataForSampleRate(48000).partialStepPoles[10][0]);
+
+        dsp::EBSaw<> saw;
+        dsp::EBPulse<> pulse;
+        saw.setSampleRate(48000);
+        pulse.setSampleRate(96000);
+        saw.setSampleRate(23456);
+
+        REQUIRE(p44.partialStepPoles == stepPoles);
+        REQUIRE(p44.blepCoeffs == coeffs);
+    }
+
+    SECTION("Concurrent Lookups Agree")
+    {
+        static constexpr int nThreads{8};
+        static constexpr int nRates{48}; // more than the lock free cache holds
+        std::array<std::array<const void *, nRates>, nThreads> res{};
+        std::vector<std::thread> ts;
+        for (int t = 0; t < nThreads; ++t)
+        {
+            ts.emplace_back([t, &res]() {
+                for (int i = 0; i < nRates; ++i)
+                {
+                    auto r = (i + t * 7) % nRates;
+                    auto sr = (r % 2 == 0) ? 48000 : 21000 + 37 * r;
+                    res[t][r] = &ch::getPoleDataForSampleRate(sr);
+                }
+            });
+        }
+        for (auto &t : ts)
+            t.join();
+
+        for (int t = 1; t < nThreads; ++t)
+            for (int r = 0; r < nRates; ++r)
+                REQUIRE(res[t][r] == res[0][r]);
+
+        for (int r = 1; r < nRates; r += 2)
+            REQUIRE(res[0][r] == &ch::getPoleDataForSampleRate(21000 + 37 * r));
+        REQUIRE(res[0][1] != res[0][3]);
+    }
+}
+
 TEST_CASE("lipol_ps class", "[dsp]")
 {
     using lipol_ps = sst::basic_blocks::dsp::lipol_sse<64, false>;
@@ -1733,4 +2520,272 @@ TEST_CASE("Sinc Delay Line interpolated reads", "[dsp]")
         }
         REQUIRE(sumCub < sumLin);
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("DPW Oscillators", "[dsp]")
+{
+    namespace dsp = sst::basic_blocks::dsp;
+    using ns = dsp::NoSmoothingStrategy;
+    static constexpr int bs{32};
+    static constexpr double srInv{1.0 / 48000};
+
+    SECTION("Closed Form Matches Differenced Cubic")
+    {
+        auto reference = [](double p, double dp) {
+            double ps[3];
+            for (int q = -1; q <= 1; ++q)
+            {
+                double ph = p - q * dp;
+                ph = ph - std::floor(ph);
+                ph = ph * 2 - 1;
+                ps[q + 1] = (ph * ph - 1) * ph / 6.0;
+            }
+            return (ps[0] + ps[2] - 2 * ps[1]) / (4 * dp * dp);
+        };
+        for (auto dp : {0.001, 0.01, 0.0731, 0.2, 0.45})
+        {
+            for (int i = 0; i <= 1000; ++i)
+            {
+                auto p = i / 1000.0;
+                INFO("dp=" << dp << " p=" << p);
+                REQUIRE(dsp::DPWSawOscillator<ns>::valueAt(p, dp) ==
+                        Approx(reference(p, dp)).margin(1e-7));
+            }
+        }
+    }
+
+    SECTION("Saw Bank Lanes Match Scalar")
+    {
+        dsp::DPWSawOscillatorBank<8> bank;
+        std::array<dsp::DPWSawOscillator<ns>, 8> ref;
+        for (int i = 0; i < 8; ++i)
+        {
+            auto f = 27.5 * std::pow(2.0, i * 1.03);
+            bank.setFrequency(i, f, srInv);
+            ref[i].retrigger();
+            ref[i].setFrequency(f, srInv);
+        }
+
+        float res[8][bs];
+        float *outs[8];
+        for (int i = 0; i < 8; ++i)
+            outs[i] = res[i];
+        for (int b = 0; b < 200; ++b)
+        {
+            bank.fillBlock<bs>(outs);
+            for (int i = 0; i < 8; ++i)
+                for (int s = 0; s < bs; ++s)
+                {
+                    INFO("lane " << i << " block " << b << " sample " << s);
+                    REQUIRE(res[i][s] == Approx(ref[i].step()).margin(2e-3));
+                }
+        }
+    }
+
+    SECTION("Pulse Bank Lanes Match Scalar")
+    {
+        dsp::DPWPulseOscillatorBank<4> bank;
+        std::array<dsp::DPWPulseOscillator<ns>, 4> ref;
+        for (int i = 0; i < 4; ++i)
+        {
+            auto f = 110 * (i + 1.37);
+            auto w = 0.1 + 0.2 * i;
+            bank.setFrequency(i, f, srInv);
+            bank.setPulseWidth(i, w);
+            ref[i].retrigger();
+            ref[i].setFrequency(f, srInv);
+            ref[i].setPulseWidth(w);
+        }
+
+        float res[4][bs];
+        float *outs[4]{res[0], res[1], res[2], res[3]};
+        for (int b = 0; b < 200; ++b)
+        {
+            bank.fillBlock<bs>(outs);
+            for (int i = 0; i < 4; ++i)
+                for (int s = 0; s < bs; ++s)
+                {
+                    INFO("lane " << i << " block " << b << " sample " << s);
+                    REQUIRE(res[i][s] == Approx(ref[i].step()).margin(2e-3));
+                }
+        }
+    }
+
+    SECTION("Unison Sum And Low Frequency Pitch")
+    {
+        dsp::DPWSawOscillatorBank<8> bank, single;
+        bank.setUnisonFrequencies(220, 0.3, srInv);
+        REQUIRE(bank.dPhaseTarget[0] < bank.dPhaseTarget[7]);
+        REQUIRE(std::sqrt(bank.dPhaseTarget[0] * bank.dPhaseTarget[7]) ==
+                Approx(220 * srInv).epsilon(1e-5));
+
+        float sum[bs], lanes[8][bs];
+        float *outs[8];
+        for (int i = 0; i < 8; ++i)
+            outs[i] = lanes[i];
+        auto copy = bank;
+        for (int b = 0; b < 20; ++b)
+        {
+            bank.fillBlockSummed<bs>(sum);
+            copy.fillBlock<bs>(outs);
+            for (int s = 0; s < bs; ++s)
+            {
+                float e = 0;
+                for (int i = 0; i < 8; ++i)
+                    e += lanes[i][s];
+                REQUIRE(sum[s] == Approx(e).margin(1e-5));
+            }
+        }
+
+        // a 1hz saw counts its zero crossings at exactly one a second after a minute
+        single.setFrequency(0, 1.0, srInv);
+        int ups{0};
+        float prior{0};
+        for (int b = 0; b < 48000 * 60 / bs; ++b)
+        {
+            single.fillBlock<bs>(outs);
+            for (int s = 0; s < bs; ++s)
+            {
+                ups += (prior < 0 && lanes[0][s] >= 0);
+                prior = lanes[0][s];
+            }
+        }
+        REQUIRE(ups == 60);
+    }
+}
+
+TEST_CASE("Wavetable Oscillator", "[dsp]")
+{
+    namespace dsp = sst::basic_blocks::dsp;
+    static constexpr int N{256}, bs{32};
+
+    // frame 0 a sine, 1 a band limited saw, 2 harmonic 40 alone, 3 minus the sine
+    std::vector<float> frames(4 * N);
+    for (int i = 0; i < N; ++i)
+    {
+        auto x = 2.0 * M_PI * i / N;
+        frames[i] = std::sin(x);
+        double saw{0};
+        for (int h = 1; h < N / 2; ++h)
+            saw += std::sin(h * x) / h;
+        frames[N + i] = saw;
+        frames[2 * N + i] = std::sin(40 * x);
+        frames[3 * N + i] = -std::sin(x);
+    }
+
+    SECTION("Mip Levels")
+    {
+        auto wt = dsp::Wavetable::build(frames.data(), N, 4);
+        REQUIRE(wt->nLevels == 8);
+        REQUIRE(wt->levelSize(0) == 2 * N);
+        REQUIRE(wt->levelSize(1) == N);
+        REQUIRE(wt->levelSize(2) == N / 2);
+        REQUIRE(wt->levelSize(7) == 16);
+
+        for (int i = 0; i < N; ++i)
+        {
+            REQUIRE(wt->frame(0, 0)[2 * i] == Approx(frames[i]).margin(1e-4));
+            REQUIRE(wt->frame(0, 1)[2 * i] == Approx(frames[N + i]).margin(1e-3));
+        }
+        REQUIRE(wt->frame(0, 1)[2 * N] == wt->frame(0, 1)[0]);
+        REQUIRE(wt->frame(0, 1)[2 * N + 1] == wt->frame(0, 1)[1]);
+        REQUIRE(wt->frame(0, 1)[-1] == wt->frame(0, 1)[2 * N - 1]);
+
+        // harmonic 40 survives while the level keeps 40 harmonics and is gone after
+        for (int l = 0; l < wt->nLevels; ++l)
+        {
+            INFO("Level " << l << " keeps " << wt->harmonicsAt(l));
+            auto sz = wt->levelSize(l);
+            float mx{0};
+            for (int i = 0; i < sz; ++i)
+                mx = std::max(mx, std::fabs(wt->frame(l, 2)[i]));
+            REQUIRE(mx == Approx(wt->harmonicsAt(l) >= 40 ? 1.f : 0.f).margin(1e-3));
+
+            for (int i = 0; i < sz; ++i)
+                REQUIRE(wt->frame(l, 0)[i] == Approx(std::sin(2.0 * M_PI * i / sz)).margin(1e-4));
+        }
+    }
+
+    SECTION("Cache Shares Tables")
+    {
+        dsp::WavetableCache cache;
+        auto a = cache.get(frames.data(), N, 4);
+        auto b = cache.get(frames.data(), N, 4);
+        auto c = cache.get(frames.data(), N, 2);
+        REQUIRE(a.get() == b.get());
+        REQUIRE(a.get() != c.get());
+        REQUIRE(cache.size() == 2);
+
+        c.reset();
+        cache.purge();
+        REQUIRE(cache.size() == 1);
+    }
+
+    SECTION("Oscillator")
+    {
+        auto wt = dsp::Wavetable::build(frames.data(), N, 4);
+        dsp::WavetableOscillator<bs> osc;
+        osc.setTable(wt);
+        osc.setSampleRate(48000);
+        float out[bs];
+
+        // the sine frame at a low pitch
+        osc.setFrequency(100);
+        osc.setMorph(0);
+        osc.retrigger();
+        for (int b = 0; b < 50; ++b)
+        {
+            osc.processBlock(out);
+            for (int s = 0; s < bs; ++s)
+            {
+                auto n = b * bs + s;
+                REQUIRE(out[s] == Approx(std::sin(2.0 * M_PI * 100 * n / 48000)).margin(2e-3));
+            }
+        }
+
+        // half way between sine and minus sine is silence
+        std::vector<float> twoFrames(frames.begin(), frames.begin() + N);
+        twoFrames.insert(twoFrames.end(), frames.begin() + 3 * N, frames.end());
+        osc.setTable(dsp::Wavetable::build(twoFrames.data(), N, 2));
+        osc.setMorph(1);
+        osc.retrigger();
+        osc.setMorph(0.5);
+        for (int b = 0; b < 10; ++b)
+        {
+            osc.processBlock(out);
+            if (b > 0)
+                for (int s = 0; s < bs; ++s)
+                    REQUIRE(out[s] == Approx(0).margin(1e-5));
+        }
+        osc.setTable(wt);
+
+        // harmonic 40 at 1.2k is 48k, way past nyquist, and must not alias back in
+        osc.setMorph(2.f / 3.f);
+        osc.setFrequency(1200);
+        osc.retrigger();
+        float mx{0};
+        for (int b = 0; b < 20; ++b)
+        {
+            osc.processBlock(out);
+            if (b > 0)
+                for (int s = 0; s < bs; ++s)
+                    mx = std::max(mx, std::fabs(out[s]));
+        }
+        REQUIRE(mx < 1e-3);
+
+        // but at 200hz it is 8k and should be there, mostly from the level which has it
+        osc.setFrequency(200);
+        osc.retrigger();
+        double ms{0};
+        for (int b = 0; b < 20; ++b)
+        {
+            osc.processBlock(out);
+            if (b > 0)
+                for (int s = 0; s < bs; ++s)
+                    ms += out[s] * out[s];
+        }
+        auto amp = std::sqrt(2 * ms / (19 * bs));
+        REQUIRE(amp > 0.85);
+        REQUIRE(amp < 1.01);
+    }
+}
@@ -33,6 +33,7 @@
 #include "sst/basic-blocks/modulators/StepLFO.h"
 #include "sst/basic-blocks/modulators/AHDSRShapedSC.h"
 #include "sst/basic-blocks/modulators/DAREnvelope.h"
+#include "sst/basic-blocks/modulators/ADSREnvelope.h"
 #include "sst/basic-blocks/tables/ExpTimeProvider.h"
 #include "test_utils.h"
 
@@ -63,6 +64,36 @@ TEST_CASE("Mod LFO Is Well Behaved", "[mod]")
     }
 }
 
+TEST_CASE("FXModControl shared sine table", "[mod]")
+{
+    using shared_t = smod::FXModControl<32>;
+    using ext_t = smod::FXModControl<32, smod::rnd_dual_stereo, true>;
+
+    std::vector<float> ext(8192);
+    for (int i = 0; i < 8192; ++i)
+        ext[i] = std::sin(2.0 * M_PI * i / 8192);
+
+    shared_t sh(48000, 1.0 / 48000);
+    ext_t ex(48000, 1.0 / 48000, ext.data());
+
+    for (int blk = 0; blk < 2000; ++blk)
+    {
+        sh.processStartOfBlock(shared_t::mod_sine, 0.0037, 1.0, 0.13, 0.7);
+        ex.processStartOfBlock(ext_t::mod_sine, 0.0037, 1.0, 0.13, 0.7);
+        auto phases = sh.getLastPhase();
+        for (int s = 0; s < 32; ++s)
+        {
+            auto a = sh.nextQuadValueInBlock();
+            auto b = ex.nextQuadValueInBlock();
+            for (int i = 0; i < 4; ++i)
+                REQUIRE(a[i] == Approx(b[i]).margin(1e-6));
+        }
+        auto end = sh.valueQuad();
+        for (int i = 0; i < 4; ++i)
+            REQUIRE(end[i] == Approx(std::sin(2.0 * M_PI * phases[i])).margin(1e-5));
+    }
+}
+
 static constexpr int bs{8};
 static constexpr double tbs{1.0 / bs};
 
@@ -82,6 +113,102 @@ TEST_CASE("You can at least make a step LFO", "[mod]")
     sst::basic_blocks::modulators::StepLFO<16>::Storage stor;
     REQUIRE(step.output == 0);
 }
+
+TEST_CASE("Transport locked StepLFO steps on the exact sample", "[mod]")
+{
+    static constexpr int lbs{16};
+    using step_t = sst::basic_blocks::modulators::StepLFO<lbs>;
+
+    sst::basic_blocks::tables::EqualTuningProvider e;
+    sst::basic_blocks::dsp::RNG rng;
+    sst::basic_blocks::modulators::Transport td;
+    td.tempo = 120;
+
+    SECTION("Looping")
+    {
+        for (auto repeat : {16, 5})
+        {
+            INFO("Repeat " << repeat);
+            step_t::Storage stor;
+            stor.repeat = repeat;
+            stor.rateIsForSingleStep = true;
+            for (int i = 0; i < step_t::Storage::stepLfoSteps; ++i)
+                stor.data[i] = (i % repeat) * 0.05f;
+
+            // 2^rate * 0.5 steps per beat at rate 1 is one step per beat, which at 120bpm
+            // and 48k is one step every 24000 samples. Start 3.5 samples in so the boundary
+            // lands at sample 23996.5, and the step should show up at sample 23997
+            static constexpr double sr{48000};
+            auto beatsPerSample = td.tempo / 60.0 / sr;
+            td.timeInBeats = 3.5 * beatsPerSample;
+
+            step_t step(e);
+            step.setSampleRate(sr, 1.0 / sr);
+            step.assign(&stor, 1.f, &td, rng, true);
+
+            int sample{0};
+            std::vector<int> boundaries;
+            for (int blk = 0; blk < 24000 * (repeat + 2) / lbs; ++blk)
+            {
+                step.processTransportLocked(1.f, false);
+                if (step.stepBoundaryOffset >= 0)
+                    boundaries.push_back(sample + step.stepBoundaryOffset);
+                for (int i = 0; i < lbs; ++i)
+                {
+                    auto expectedStep = (int)std::floor(td.timeInBeats + i * beatsPerSample);
+                    REQUIRE(step.outputBlock[i] == Approx((expectedStep % repeat) * 0.05f));
+                }
+                td.timeInBeats += lbs * beatsPerSample;
+                sample += lbs;
+            }
+            REQUIRE(boundaries.size() == (size_t)repeat + 2);
+            for (size_t i = 0; i < boundaries.size(); ++i)
+                REQUIRE(boundaries[i] == 23997 + 24000 * (int)i);
+        }
+    }
+
+    SECTION("One shot holds the last step")
+    {
+        static constexpr int repeat{4};
+        step_t::Storage stor;
+        stor.repeat = repeat;
+        stor.rateIsForSingleStep = true;
+        stor.smooth = 0.6f;
+        for (int i = 0; i < repeat; ++i)
+            stor.data[i] = 0.1f + 0.2f * i;
+
+        static constexpr double sr{48000};
+        auto beatsPerSample = td.tempo / 60.0 / sr;
+        td.timeInBeats = 3.5 * beatsPerSample;
+
+        step_t step(e);
+        step.setSampleRate(sr, 1.0 / sr);
+        step.assign(&stor, 1.f, &td, rng, true);
+
+        int sample{0};
+        std::vector<int> boundaries;
+        for (int blk = 0; blk < 24000 * (repeat + 4) / lbs; ++blk)
+        {
+            step.processTransportLocked(1.f, true);
+            if (step.stepBoundaryOffset >= 0)
+                boundaries.push_back(sample + step.stepBoundaryOffset);
+            for (int i = 0; i < lbs; ++i)
+            {
+                if (td.timeInBeats + i * beatsPerSample >= repeat - 1)
+                {
+                    INFO("Sample " << sample + i);
+                    REQUIRE(step.outputBlock[i] == Approx(stor.data[repeat - 1]).margin(1e-5));
+                }
+            }
+            td.timeInBeats += lbs * beatsPerSample;
+            sample += lbs;
+        }
+        // steps 1 through repeat - 1 begin, and nothing after the pattern ends
+        REQUIRE(boundaries.size() == (size_t)repeat - 1);
+        for (size_t i = 0; i < boundaries.size(); ++i)
+            REQUIRE(boundaries[i] == 23997 + 24000 * (int)i);
+    }
+}
 #if 0
 // Well it turns out random isn't strictly bounded, so this test is no good, but we are
 // close to boudned now so leave it here in case we want to tweak more
@@ -266,3 +393,191 @@ TEST_CASE("DAREnvelope temposync dPhase lands on note durations", "[mod]")
         }
     }
 }
+
+TEST_CASE("ADSREnvelope cached rates follow sample rate changes", "[mod]")
+{
+    struct MutableSRProvider
+    {
+        double samplerate{48000};
+        float envelope_rate_linear_nowrap(float f) const { return bs / samplerate * pow(2.f, -f); }
+    } sr;
+
+    using env_t = smod::ADSREnvelope<MutableSRProvider, bs>;
+
+    auto attackBlocks = [&sr](bool digital) {
+        env_t env(&sr);
+        env.attackFrom(0, 0, 1, digital);
+        int blocks{0};
+        while (env.stage == env_t::s_attack && blocks < 100000)
+        {
+            for (int i = 0; i < bs; ++i)
+                env.process(0.3, 0.3, 0.5, 0.3, 1, 1, 1, true);
+            blocks++;
+        }
+        return blocks;
+    };
+
+    for (auto dig : {true, false})
+    {
+        INFO("Digital " << dig);
+        sr.samplerate = 48000;
+        auto b48 = attackBlocks(dig);
+        sr.samplerate = 96000;
+        auto b96 = attackBlocks(dig);
+        REQUIRE(b48 > 10);
+        REQUIRE(b96 == Approx(2 * b48).margin(2));
+    }
+
+    // and a single envelope which sees the rate change mid-stage picks up the new rate
+    sr.samplerate = 48000;
+    env_t env(&sr);
+    env.attackFrom(0, 0, 1, true);
+    for (int i = 0; i < bs; ++i)
+        env.process(0.3, 0.3, 0.5, 0.3, 1, 1, 1, true);
+    auto p48 = env.phase;
+    sr.samplerate = 96000;
+    env.onSampleRateChanged();
+    for (int i = 0; i < bs; ++i)
+        env.process(0.3, 0.3, 0.5, 0.3, 1, 1, 1, true);
+    REQUIRE(env.phase - p48 == Approx(p48 * 0.5).epsilon(1e-4));
+}
+
+TEST_CASE("DiscreteStagesEnvelope cubed output can be omitted", "[mod]")
+{
+    SRProvider sr;
+    using cube_t = smod::ADSREnvelope<SRProvider, bs>;
+    using nocube_t = smod::ADSREnvelope<SRProvider, bs, smod::NoCubedOutput<smod::TenSecondRange>>;
+    static_assert(cube_t::computeCubedOutput);
+    static_assert(!nocube_t::computeCubedOutput);
+
+    cube_t withCube(&sr);
+    nocube_t noCube(&sr);
+    withCube.attackFrom(0, 0, 1, true);
+    noCube.attackFrom(0, 0, 1, true);
+
+    for (int blk = 0; blk < 2000; ++blk)
+    {
+        auto gate = blk < 1000;
+        withCube.processBlock(0.2, 0.2, 0.6, 0.2, 1, 1, 1, gate);
+        noCube.processBlock(0.2, 0.2, 0.6, 0.2, 1, 1, 1, gate);
+
+        auto cb = withCube.outputBlock();
+        auto ncb = noCube.outputBlock();
+        auto cbc = withCube.outputCubedBlock();
+        for (int i = 0; i < bs; ++i)
+        {
+            REQUIRE(cb[i] == ncb[i]);
+            REQUIRE(cbc[i] == Approx(cb[i] * cb[i] * cb[i]).margin(1e-6));
+        }
+        REQUIRE(withCube.output == noCube.output);
+        REQUIRE(noCube.outputCubed == 0.f);
+    }
+}
+
+TEST_CASE("AHDSRShapedSC curve table matches the analytic kernel", "[mod]")
+{
+    using tab_t = smod::AHDSRShapedCurveTable;
+    tab_t::initialize();
+
+    for (float shape = -1.f; shape <= 1.f; shape += 0.0137f)
+    {
+        for (float p = 0.f; p <= 1.f; p += 0.0093f)
+        {
+            INFO("shape=" << shape << " p=" << p);
+            REQUIRE(tab_t::lookup(p, shape) == Approx(tab_t::exactKernel(p, shape)).margin(3e-4));
+        }
+    }
+
+    SECTION("Flat shape is the identity on the phase argument")
+    {
+        // kernel once returned the member phase here rather than its argument
+        test_utils::TestSRProvider sr;
+        smod::AHDSRShapedSC<test_utils::TestSRProvider, test_utils::blockSize> env(&sr);
+        env.phase = 0.f;
+        for (auto p : {0.1f, 0.3f, 0.77f})
+        {
+            REQUIRE(env.kernel(p, 0.f) == p);
+            REQUIRE(env.kernel(p, 5e-5f) == p);
+        }
+    }
+
+    SECTION("SIMD lookup matches scalar")
+    {
+        float ps alignas(16)[4], ss alignas(16)[4], res alignas(16)[4];
+        for (int i = 0; i < 1000; ++i)
+        {
+            for (int j = 0; j < 4; ++j)
+            {
+                ps[j] = (float)rand() / (float)RAND_MAX;
+                ss[j] = 2.f * (float)rand() / (float)RAND_MAX - 1.f;
+            }
+            SIMD_MM(store_ps)(res, tab_t::lookup(SIMD_MM(load_ps)(ps), SIMD_MM(load_ps)(ss)));
+            for (int j = 0; j < 4; ++j)
+                REQUIRE(res[j] == Approx(tab_t::lookup(ps[j], ss[j])).margin(1e-6));
+        }
+    }
+}
+
+TEST_CASE("AHDSRShapedSC batched voices match one at a time", "[mod]")
+{
+    using namespace test_utils;
+    TestSRProvider sr;
+    using env_t = smod::AHDSRShapedSC<TestSRProvider, blockSize>;
+    static constexpr size_t nVoices{11};
+
+    for (auto needsCurve : {true, false})
+    {
+        INFO("needsCurve=" << needsCurve);
+        std::vector<env_t> single, batched;
+        std::vector<env_t::BlockParams> params(nVoices);
+        for (size_t v = 0; v < nVoices; ++v)
+        {
+            single.emplace_back(&sr);
+            batched.emplace_back(&sr);
+            auto &p = params[v];
+            p.delay = (v % 3 == 0) ? 0.1f : 0.f;
+            p.a = 0.1f + 0.05f * v;
+            p.h = (v % 2) ? 0.1f : 0.f;
+            p.d = 0.3f;
+            p.s = 0.1f * (v % 7);
+            p.r = 0.35f;
+            p.ashape = -1.f + 0.2f * v;
+            p.dshape = (v % 4 == 0) ? 0.f : 0.6f;
+            p.rshape = -0.4f;
+            p.rateMul = 1.f + 0.1f * (v % 3);
+        }
+        std::vector<env_t *> ptrs;
+        for (auto &e : batched)
+            ptrs.push_back(&e);
+
+        for (int b = 0; b < 3000; ++b)
+        {
+            for (size_t v = 0; v < nVoices; ++v)
+            {
+                auto pos = (b + 97 * v) % 1000;
+                params[v].gateActive = pos < 700;
+                if (pos == 0)
+                {
+                    single[v].attackFromWithDelay(0.f, params[v].delay, params[v].a);
+                    batched[v].attackFromWithDelay(0.f, params[v].delay, params[v].a);
+                }
+                const auto &p = params[v];
+                single[v].processBlockWithDelayAndRateMul(p.delay, p.a, p.h, p.d, p.s, p.r,
+                                                          p.ashape, p.dshape, p.rshape, p.rateMul,
+                                                          p.gateActive, needsCurve);
+            }
+            env_t::processBlocks(ptrs.data(), params.data(), nVoices, needsCurve);
+
+            for (size_t v = 0; v < nVoices; ++v)
+            {
+                INFO("block " << b << " voice " << v);
+                REQUIRE(batched[v].stage == single[v].stage);
+                REQUIRE(batched[v].outBlock0 == Approx(single[v].outBlock0).margin(1e-6));
+                if (needsCurve)
+                    for (int i = 0; i < blockSize; ++i)
+                        REQUIRE(batched[v].outputCache[i] ==
+                                Approx(single[v].outputCache[i]).margin(1e-6));
+            }
+        }
+    }
+}
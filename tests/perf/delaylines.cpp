@@ -0,0 +1,102 @@
+/*
+ * sst-basic-blocks - an open source library of core audio utilities
+ * built by Surge Synth Team.
+ *
+ * Provides a collection of tools useful on the audio thread for blocks,
+ * modulation, etc... or useful for adapting code to multiple environments.
+ *
+ * Copyright 2023, various authors, as described in the GitHub
+ * transaction log. Parts of this code are derived from similar
+ * functions original in Surge or ShortCircuit.
+ *
+ * sst-basic-blocks is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html.
+ *
+ * A very small number of explicitly chosen header files can also be
+ * used in an MIT/BSD context. Please see the README.md file in this
+ * repo or the comments in the individual files. Only headers with an
+ * explicit mention that they are dual licensed may be copied and reused
+ * outside the GPL3 terms.
+ *
+ * All source in sst-basic-blocks available at
+ * https://github.com/surge-synthesizer/sst-basic-blocks
+ */
+
+#include <iostream>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sst/basic-blocks/dsp/SSESincDelayLine.h"
+#include "perfutils.h"
+
+static constexpr int dlCombSize{16384};
+static constexpr double dlSampleRate{48000};
+static constexpr double dlSecondsRendered{20};
+static constexpr int dlInstances{16};
+
+/*
+ * Each run writes and reads a four line diffusion network sample by sample, for a number of
+ * instances. The percentage printed is of one core for all the instances in realtime.
+ */
+template <typename F> void runDelayLines(const std::string &what, F &&perInstanceSample)
+{
+    auto samples = (int)(dlSecondsRendered * dlSampleRate);
+    perf::TimeGuard tg(what + " instances=" + std::to_string(dlInstances), __FILE__, __LINE__,
+                       (int)(dlSecondsRendered * 1000000));
+    for (int s = 0; s < samples; ++s)
+        for (int i = 0; i < dlInstances; ++i)
+            perInstanceSample(i, s);
+}
+
+static float dlSink{0.f};
+
+template <bool hw>
+void quadDelayLinePerformance(const sst::basic_blocks::tables::SurgeSincTableProvider &st)
+{
+    using line_t = sst::basic_blocks::dsp::quadDelayLine<dlCombSize, hw>;
+    std::string pfx = std::string("quadDelayLine ") +
+                      (line_t::usesHardwareGather ? "avx2 gather " : "scalar gather ");
+
+    std::vector<std::unique_ptr<line_t>> lines;
+    for (int i = 0; i < dlInstances; ++i)
+        lines.push_back(std::make_unique<line_t>(st));
+    auto in = SIMD_MM(setr_ps)(0.1f, 0.2f, 0.3f, 0.4f);
+    auto delayFor = [](int s) {
+        auto m = (float)std::sin(s * 0.0003);
+        return SIMD_MM(setr_ps)(1031.3f + 37.f * m, 1327.1f - 29.f * m, 1523.7f + 41.f * m,
+                                1871.9f - 23.f * m);
+    };
+
+    runDelayLines(pfx + "write", [&](int i, int) { lines[i]->write(in); });
+
+    runDelayLines(pfx + "write+linear", [&](int i, int s) {
+        auto r = lines[i]->read(delayFor(s));
+        lines[i]->write(SIMD_MM(add_ps)(in, SIMD_MM(mul_ps)(r, SIMD_MM(set1_ps)(0.5f))));
+        dlSink += SIMD_MM(cvtss_f32)(r);
+    });
+
+    runDelayLines(pfx + "write+cubic", [&](int i, int s) {
+        auto r = lines[i]->readCubic(delayFor(s));
+        lines[i]->write(SIMD_MM(add_ps)(in, SIMD_MM(mul_ps)(r, SIMD_MM(set1_ps)(0.5f))));
+        dlSink += SIMD_MM(cvtss_f32)(r);
+    });
+
+    runDelayLines(pfx + "write+sinc", [&](int i, int s) {
+        auto r = lines[i]->readSinc(delayFor(s));
+        lines[i]->write(SIMD_MM(add_ps)(in, SIMD_MM(mul_ps)(r, SIMD_MM(set1_ps)(0.5f))));
+        dlSink += SIMD_MM(cvtss_f32)(r);
+    });
+}
+
+void delayLinePerformance()
+{
+    std::cout << __FILE__ << ":" << __LINE__ << " Delay Line Perf starting" << std::endl;
+    auto st = std::make_unique<sst::basic_blocks::tables::SurgeSincTableProvider>();
+    quadDelayLinePerformance<false>(*st);
+    quadDelayLinePerformance<true>(*st);
+    std::cout << "Sink " << dlSink << std::endl;
+}
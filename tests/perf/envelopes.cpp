@@ -0,0 +1,158 @@
+/*
+ * sst-basic-blocks - an open source library of core audio utilities
+ * built by Surge Synth Team.
+ *
+ * Provides a collection of tools useful on the audio thread for blocks,
+ * modulation, etc... or useful for adapting code to multiple environments.
+ *
+ * Copyright 2023, various authors, as described in the GitHub
+ * transaction log. Parts of this code are derived from similar
+ * functions original in Surge or ShortCircuit.
+ *
+ * sst-basic-blocks is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html.
+ *
+ * A very small number of explicitly chosen header files can also be
+ * used in an MIT/BSD context. Please see the README.md file in this
+ * repo or the comments in the individual files. Only headers with an
+ * explicit mention that they are dual licensed may be copied and reused
+ * outside the GPL3 terms.
+ *
+ * All source in sst-basic-blocks available at
+ * https://github.com/surge-synthesizer/sst-basic-blocks
+ */
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <string>
+
+#include "sst/basic-blocks/modulators/ADSREnvelope.h"
+#include "sst/basic-blocks/modulators/AHDSRShapedSC.h"
+#include "perfutils.h"
+
+static constexpr int envBlockSize{64};
+
+struct EnvSRProvider
+{
+    double samplerate{48000}, sampleRate{48000}, sampleRateInv{1.0 / 48000};
+    float envelope_rate_linear_nowrap(float f) const
+    {
+        return envBlockSize * sampleRateInv * std::pow(2.f, -f);
+    }
+    void setSampleRate(double sr)
+    {
+        samplerate = sr;
+        sampleRate = sr;
+        sampleRateInv = 1.0 / sr;
+    }
+};
+
+/*
+ * Each run plays a note on every voice, holds it for most of the run and releases it,
+ * retriggering so we cover every stage. The percentage printed is of one core for all
+ * the voices in realtime.
+ */
+static constexpr int nVoices{64};
+static constexpr double secondsRendered{20};
+
+template <typename F> void runVoices(const std::string &what, double sr, F &&perVoiceBlock)
+{
+    auto blocks = (int)(secondsRendered * sr / envBlockSize);
+    perf::TimeGuard tg(what + " sr=" + std::to_string((int)sr) + " voices=" +
+                           std::to_string(nVoices),
+                       __FILE__, __LINE__, (int)(secondsRendered * 1000000));
+    for (int b = 0; b < blocks; ++b)
+    {
+        auto pos = b % 2000;
+        for (int v = 0; v < nVoices; ++v)
+            perVoiceBlock(v, pos == 0, pos < 1600);
+    }
+}
+
+static float sink{0.f};
+
+void envelopePerformance()
+{
+    std::cout << __FILE__ << ":" << __LINE__ << " Envelope Perf starting" << std::endl;
+    for (auto sr : {48000.0, 96000.0})
+    {
+        EnvSRProvider srp;
+        srp.setSampleRate(sr);
+
+        using adsr_t = sst::basic_blocks::modulators::ADSREnvelope<EnvSRProvider, envBlockSize>;
+        using shaped_t = sst::basic_blocks::modulators::AHDSRShapedSC<EnvSRProvider, envBlockSize>;
+
+        for (auto digital : {true, false})
+        {
+            std::vector<adsr_t> envs;
+            for (int v = 0; v < nVoices; ++v)
+                envs.emplace_back(&srp);
+
+            runVoices(digital ? "ADSR digital" : "ADSR analog", sr,
+                      [&](int v, bool retrig, bool gate) {
+                          auto &e = envs[v];
+                          if (retrig)
+                              e.attackFrom(0, 0, 1, digital);
+                          e.processBlock(0.3, 0.4, 0.6, 0.3, 1, 1, 1, gate);
+                          sink += e.outputCache[envBlockSize - 1];
+                      });
+        }
+
+        {
+            std::vector<shaped_t> envs;
+            for (int v = 0; v < nVoices; ++v)
+                envs.emplace_back(&srp);
+
+            runVoices("AHDSRShapedSC shaped", sr, [&](int v, bool retrig, bool gate) {
+                auto &e = envs[v];
+                if (retrig)
+                    e.attackFrom(0.f);
+                e.processBlock(0.3, 0.1, 0.4, 0.6, 0.3, 0.4, -0.3, 0.2, gate, true);
+                sink += e.outputCache[envBlockSize - 1];
+            });
+        }
+
+        {
+            std::vector<shaped_t> envs;
+            for (int v = 0; v < nVoices; ++v)
+                envs.emplace_back(&srp);
+            std::vector<shaped_t *> ptrs;
+            for (auto &e : envs)
+                ptrs.push_back(&e);
+            std::vector<shaped_t::BlockParams> params(nVoices);
+            for (auto &p : params)
+            {
+                p.a = 0.3;
+                p.h = 0.1;
+                p.d = 0.4;
+                p.s = 0.6;
+                p.r = 0.3;
+                p.ashape = 0.4;
+                p.dshape = -0.3;
+                p.rshape = 0.2;
+            }
+
+            // the same voices as above, all advanced through one processBlocks call per block
+            auto blocks = (int)(secondsRendered * sr / envBlockSize);
+            perf::TimeGuard tg("AHDSRShapedSC shaped batched sr=" + std::to_string((int)sr) +
+                                   " voices=" + std::to_string(nVoices),
+                               __FILE__, __LINE__, (int)(secondsRendered * 1000000));
+            for (int b = 0; b < blocks; ++b)
+            {
+                auto pos = b % 2000;
+                for (int v = 0; v < nVoices; ++v)
+                {
+                    if (pos == 0)
+                        envs[v].attackFrom(0.f);
+                    params[v].gateActive = pos < 1600;
+                }
+                shaped_t::processBlocks(ptrs.data(), params.data(), nVoices, true);
+                sink += envs[b % nVoices].outputCache[envBlockSize - 1];
+            }
+        }
+    }
+    std::cout << "Sink " << sink << std::endl;
+}
@@ -0,0 +1,204 @@
+/*
+ * sst-basic-blocks - an open source library of core audio utilities
+ * built by Surge Synth Team.
+ *
+ * Provides a collection of tools useful on the audio thread for blocks,
+ * modulation, etc... or useful for adapting code to multiple environments.
+ *
+ * Copyright 2023, various authors, as described in the GitHub
+ * transaction log. Parts of this code are derived from similar
+ * functions original in Surge or ShortCircuit.
+ *
+ * sst-basic-blocks is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html.
+ *
+ * A very small number of explicitly chosen header files can also be
+ * used in an MIT/BSD context. Please see the README.md file in this
+ * repo or the comments in the individual files. Only headers with an
+ * explicit mention that they are dual licensed may be copied and reused
+ * outside the GPL3 terms.
+ *
+ * All source in sst-basic-blocks available at
+ * https://github.com/surge-synthesizer/sst-basic-blocks
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sst/basic-blocks/dsp/DPWSawPulseOscillator.h"
+#include "sst/basic-blocks/dsp/QuadratureOscillators.h"
+#include "sst/basic-blocks/dsp/WavetableOscillator.h"
+#include "perfutils.h"
+
+static constexpr int oscBlockSize{32};
+static constexpr double oscSampleRate{48000};
+static constexpr double oscSecondsRendered{20};
+static constexpr int oscVoices{16};
+
+static float oscSink{0.f};
+
+/*
+ * A 16 voice unison stack rendered a block at a time. The percentage printed is of one core
+ * for the whole stack in realtime.
+ */
+template <typename F> void runOscillators(const std::string &what, F &&perBlock)
+{
+    auto blocks = (int)(oscSecondsRendered * oscSampleRate / oscBlockSize);
+    perf::TimeGuard tg(what + " voices=" + std::to_string(oscVoices), __FILE__, __LINE__,
+                       (int)(oscSecondsRendered * 1000000));
+    for (int b = 0; b < blocks; ++b)
+        perBlock();
+}
+
+template <bool isPulse> void dpwPerformance()
+{
+    namespace dsp = sst::basic_blocks::dsp;
+    using ss = dsp::BlockInterpSmoothingStrategy<oscBlockSize>;
+    using scalar_t =
+        std::conditional_t<isPulse, dsp::DPWPulseOscillator<ss>, dsp::DPWSawOscillator<ss>>;
+    std::string pfx = isPulse ? "DPW pulse " : "DPW saw ";
+    auto srInv = 1.0 / oscSampleRate;
+    auto freq = [](int v) { return 110.0 * std::pow(2.0, (v - oscVoices / 2) * 0.003); };
+
+    float out alignas(16)[oscBlockSize];
+
+    std::array<scalar_t, oscVoices> scalar;
+    for (auto &s : scalar)
+        s.retrigger();
+    runOscillators(pfx + "scalar", [&]() {
+        std::fill(out, out + oscBlockSize, 0.f);
+        for (int v = 0; v < oscVoices; ++v)
+        {
+            scalar[v].setFrequency(freq(v), srInv);
+            if constexpr (isPulse)
+                scalar[v].setPulseWidth(0.3);
+            for (int s = 0; s < oscBlockSize; ++s)
+                out[s] += scalar[v].step();
+        }
+        oscSink += out[7];
+    });
+
+    dsp::DPWOscillatorBank<oscVoices, isPulse> bank;
+    runOscillators(pfx + "bank", [&]() {
+        for (int v = 0; v < oscVoices; ++v)
+        {
+            bank.setFrequency(v, freq(v), srInv);
+            if constexpr (isPulse)
+                bank.setPulseWidth(v, 0.3);
+        }
+        bank.template fillBlockSummed<oscBlockSize>(out);
+        oscSink += out[7];
+    });
+}
+
+/*
+ * One 256 partial additive voice, as scalar quadrature oscillators and as a bank, with the
+ * partials' pitches changing every block.
+ */
+void additivePerformance()
+{
+    namespace dsp = sst::basic_blocks::dsp;
+    static constexpr int nPartials{256};
+    auto blocks = (int)(oscSecondsRendered * oscSampleRate / oscBlockSize);
+    auto omegaFor = [](int b, int p) {
+        return (float)(0.0003 * (p + 1) * (1 + 0.01 * std::sin(b * 0.01)));
+    };
+    float out alignas(16)[oscBlockSize];
+
+    {
+        std::vector<dsp::QuadratureOscillator<float, oscBlockSize>> scalar(nPartials);
+        perf::TimeGuard tg("Additive scalar partials=256", __FILE__, __LINE__,
+                           (int)(oscSecondsRendered * 1000000));
+        for (int b = 0; b < blocks; ++b)
+        {
+            std::fill(out, out + oscBlockSize, 0.f);
+            for (int p = 0; p < nPartials; ++p)
+            {
+                auto &q = scalar[p];
+                q.setRateForBlock(omegaFor(b, p));
+                auto a = 1.f / (p + 1);
+                for (int s = 0; s < oscBlockSize; ++s)
+                {
+                    q.blockStep();
+                    out[s] += a * q.v;
+                }
+            }
+            oscSink += out[7];
+        }
+    }
+
+    {
+        auto bank = std::make_unique<dsp::QuadratureOscillatorBank<nPartials, oscBlockSize>>();
+        perf::TimeGuard tg("Additive bank partials=256", __FILE__, __LINE__,
+                           (int)(oscSecondsRendered * 1000000));
+        for (int b = 0; b < blocks; ++b)
+        {
+            for (int p = 0; p < nPartials; ++p)
+                bank->setPartial(p, omegaFor(b, p), 1.f / (p + 1));
+            bank->processBlock(out);
+            oscSink += out[7];
+        }
+    }
+}
+
+/*
+ * Building a 64 frame, 2048 sample wavetable, then 128 voices of it morphing.
+ */
+void wavetablePerformance()
+{
+    namespace dsp = sst::basic_blocks::dsp;
+    static constexpr int frameSize{2048}, nFrames{64}, nVoices{128};
+    std::vector<float> frames(frameSize * nFrames);
+    for (int f = 0; f < nFrames; ++f)
+        for (int i = 0; i < frameSize; ++i)
+        {
+            auto x = 2.0 * M_PI * i / frameSize;
+            frames[f * frameSize + i] = (float)std::tanh((1 + f * 0.2) * std::sin(x));
+        }
+
+    dsp::WavetableCache cache;
+    std::shared_ptr<const dsp::Wavetable> wt;
+    {
+        perf::TimeGuard tg("Wavetable build 64x2048", __FILE__, __LINE__, 1000000);
+        wt = cache.get(frames.data(), frameSize, nFrames);
+    }
+
+    std::vector<dsp::WavetableOscillator<oscBlockSize>> voices(nVoices);
+    for (int v = 0; v < nVoices; ++v)
+    {
+        voices[v].setTable(cache.get(frames.data(), frameSize, nFrames));
+        voices[v].setSampleRate(oscSampleRate);
+        voices[v].setFrequency(55.0 * std::pow(2.0, v / 24.0));
+        voices[v].retrigger(v * 0.17f);
+    }
+    auto blocks = (int)(oscSecondsRendered * oscSampleRate / oscBlockSize);
+    float out alignas(16)[oscBlockSize];
+    perf::TimeGuard tg("Wavetable voices=128", __FILE__, __LINE__,
+                       (int)(oscSecondsRendered * 1000000));
+    for (int b = 0; b < blocks; ++b)
+    {
+        for (int v = 0; v < nVoices; ++v)
+        {
+            voices[v].setMorph(0.5f + 0.5f * std::sin(b * 0.001 + v));
+            voices[v].processBlock(out);
+            oscSink += out[5];
+        }
+    }
+}
+
+void oscillatorPerformance()
+{
+    std::cout << __FILE__ << ":" << __LINE__ << " Oscillator Perf starting" << std::endl;
+    dpwPerformance<false>();
+    dpwPerformance<true>();
+    additivePerformance();
+    wavetablePerformance();
+    std::cout << "Sink " << oscSink << std::endl;
+}
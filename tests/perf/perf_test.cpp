@@ -27,5 +27,18 @@
 #include <iostream>
 
 extern void lfoPerformance();
+extern void envelopePerformance();
+extern void resamplerPerformance();
+extern void delayLinePerformance();
+extern void oscillatorPerformance();
+extern void tablesPerformance();
 
-int main(int argc, char **argv) { lfoPerformance(); }
+int main(int argc, char **argv)
+{
+    lfoPerformance();
+    envelopePerformance();
+    resamplerPerformance();
+    delayLinePerformance();
+    oscillatorPerformance();
+    tablesPerformance();
+}
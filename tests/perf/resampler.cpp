@@ -0,0 +1,124 @@
+/*
+ * sst-basic-blocks - an open source library of core audio utilities
+ * built by Surge Synth Team.
+ *
+ * Provides a collection of tools useful on the audio thread for blocks,
+ * modulation, etc... or useful for adapting code to multiple environments.
+ *
+ * Copyright 2023, various authors, as described in the GitHub
+ * transaction log. Parts of this code are derived from similar
+ * functions original in Surge or ShortCircuit.
+ *
+ * sst-basic-blocks is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html.
+ *
+ * A very small number of explicitly chosen header files can also be
+ * used in an MIT/BSD context. Please see the README.md file in this
+ * repo or the comments in the individual files. Only headers with an
+ * explicit mention that they are dual licensed may be copied and reused
+ * outside the GPL3 terms.
+ *
+ * All source in sst-basic-blocks available at
+ * https://github.com/surge-synthesizer/sst-basic-blocks
+ */
+
+#include <iostream>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "sst/basic-blocks/dsp/LanczosResampler.h"
+#include "perfutils.h"
+
+static constexpr int rsBlockSize{32};
+static constexpr double rsSampleRate{48000};
+static constexpr double rsSecondsRendered{20};
+static constexpr int rsInstances{16};
+
+/*
+ * Each run oversamples a stereo stream into a block and back down, for a number of
+ * instances, as an oversampled nonlinear stage would. The percentage printed is of one
+ * core for all the instances in realtime.
+ */
+template <typename F> void runResampler(const std::string &what, F &&perInstanceBlock)
+{
+    auto blocks = (int)(rsSecondsRendered * rsSampleRate / rsBlockSize);
+    perf::TimeGuard tg(what + " instances=" + std::to_string(rsInstances), __FILE__, __LINE__,
+                       (int)(rsSecondsRendered * 1000000));
+    for (int b = 0; b < blocks; ++b)
+        for (int i = 0; i < rsInstances; ++i)
+            perInstanceBlock(i, b);
+}
+
+static float rsSink{0.f};
+
+template <int factor> void oversamplingPerformance()
+{
+    namespace dsp = sst::basic_blocks::dsp;
+    static constexpr int osBlockSize{rsBlockSize * factor};
+
+    float inL alignas(16)[rsBlockSize], inR alignas(16)[rsBlockSize];
+    float osL alignas(16)[osBlockSize], osR alignas(16)[osBlockSize];
+    float outL alignas(16)[rsBlockSize], outR alignas(16)[rsBlockSize];
+    for (int i = 0; i < rsBlockSize; ++i)
+    {
+        inL[i] = std::sin(i * 0.1);
+        inR[i] = std::cos(i * 0.07);
+    }
+
+    auto pfx = std::to_string(factor) + "x ";
+    {
+        using up_t = dsp::LanczosResampler<osBlockSize>;
+        using down_t = dsp::LanczosResampler<rsBlockSize>;
+        std::vector<std::unique_ptr<up_t>> ups;
+        std::vector<std::unique_ptr<down_t>> downs;
+        for (int i = 0; i < rsInstances; ++i)
+        {
+            ups.push_back(std::make_unique<up_t>(rsSampleRate, rsSampleRate * factor));
+            downs.push_back(std::make_unique<down_t>(rsSampleRate * factor, rsSampleRate));
+        }
+
+        runResampler(pfx + "generic LanczosResampler", [&](int n, int) {
+            auto &u = *ups[n];
+            auto &d = *downs[n];
+            for (int i = 0; i < rsBlockSize; ++i)
+                u.push(inL[i], inR[i]);
+            u.populateNextBlockSize(osL, osR);
+            for (int i = 0; i < osBlockSize; ++i)
+                d.push(osL[i], osR[i]);
+            d.populateNextBlockSize(outL, outR);
+            u.renormalizePhases();
+            d.renormalizePhases();
+            rsSink += outL[rsBlockSize - 1];
+        });
+    }
+
+    {
+        using up_t = dsp::LanczosPolyphaseUpsampler<factor, rsBlockSize>;
+        using down_t = dsp::LanczosPolyphaseDownsampler<factor, rsBlockSize>;
+        std::vector<std::unique_ptr<up_t>> ups;
+        std::vector<std::unique_ptr<down_t>> downs;
+        for (int i = 0; i < rsInstances; ++i)
+        {
+            ups.push_back(std::make_unique<up_t>());
+            downs.push_back(std::make_unique<down_t>());
+        }
+
+        runResampler(pfx + "LanczosPolyphase", [&](int n, int) {
+            ups[n]->process(inL, inR, osL, osR);
+            downs[n]->process(osL, osR, outL, outR);
+            rsSink += outL[rsBlockSize - 1];
+        });
+    }
+}
+
+void resamplerPerformance()
+{
+    std::cout << __FILE__ << ":" << __LINE__ << " Resampler Perf starting" << std::endl;
+    oversamplingPerformance<2>();
+    oversamplingPerformance<4>();
+    std::cout << "Sink " << rsSink << std::endl;
+}
@@ -0,0 +1,205 @@
+/*
+ * sst-basic-blocks - an open source library of core audio utilities
+ * built by Surge Synth Team.
+ *
+ * Provides a collection of tools useful on the audio thread for blocks,
+ * modulation, etc... or useful for adapting code to multiple environments.
+ *
+ * Copyright 2023, various authors, as described in the GitHub
+ * transaction log. Parts of this code are derived from similar
+ * functions original in Surge or ShortCircuit.
+ *
+ * sst-basic-blocks is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html.
+ *
+ * A very small number of explicitly chosen header files can also be
+ * used in an MIT/BSD context. Please see the README.md file in this
+ * repo or the comments in the individual files. Only headers with an
+ * explicit mention that they are dual licensed may be copied and reused
+ * outside the GPL3 terms.
+ *
+ * All source in sst-basic-blocks available at
+ * https://github.com/surge-synthesizer/sst-basic-blocks
+ */
+
+
+#include <iostream>
+
+#include "sst/basic-blocks/tables/SixSinesWaveProvider.h"
+#include "sst/basic-blocks/tables/EqualTuningProvider.h"
+#include "sst/basic-blocks/tables/TwoToTheXProvider.h"
+#include "sst/basic-blocks/tables/DbToLinearProvider.h"
+#include "perfutils.h"
+
+/*
+ * What a host pays to load a plugin using the six sines tables. Each of these only does
+ * work the first time in a process, so the order here matters; the percentage printed is
+ * of one second.
+ */
+void tablesPerformance()
+{
+    using ssw = sst::basic_blocks::tables::SixSinesWaveProvider;
+    std::cout << __FILE__ << ":" << __LINE__ << " Tables Perf starting" << std::endl;
+    float sink{0};
+    {
+        perf::TimeGuard tg("SixSines first provider (sine only)", __FILE__, __LINE__, 1000000);
+        ssw p;
+        sink += p.at(12345);
+    }
+    {
+        perf::TimeGuard tg("SixSines all waves provider", __FILE__, __LINE__, 1000000);
+        ssw p(true);
+        sink += p.at(12345);
+    }
+    {
+        perf::TimeGuard tg("SixSines first use of one waveform", __FILE__, __LINE__, 1000000);
+        ssw p(true);
+        p.setWaveForm(ssw::SAWISH);
+        sink += p.at(12345);
+    }
+    {
+        perf::TimeGuard tg("SixSines prepare every waveform", __FILE__, __LINE__, 1000000);
+        ssw::initializeStatics(true);
+    }
+    {
+        perf::TimeGuard tg("SixSines prepare every half resolution waveform", __FILE__, __LINE__,
+                           1000000);
+        for (int wf = 0; wf < ssw::NUM_WAVEFORMS; ++wf)
+            ssw::prepareWaveForm((ssw::WaveForm)wf, true);
+    }
+
+    // a six operator FM voice's table reads, 32 samples a block for 20 seconds at 48k
+    static constexpr int bs{32}, nOps{6}, blocks{48000 * 20 / bs};
+    uint32_t phases[nOps][bs];
+    float out[nOps][bs];
+    const uint32_t *ph[nOps];
+    float *outs[nOps];
+    for (int op = 0; op < nOps; ++op)
+    {
+        ph[op] = phases[op];
+        outs[op] = out[op];
+        for (int i = 0; i < bs; ++i)
+            phases[op][i] = (uint32_t)(i * 39131 * (op + 1));
+    }
+    auto advance = [&]() {
+        for (int op = 0; op < nOps; ++op)
+            for (int i = 0; i < bs; ++i)
+                phases[op][i] += 39131 * bs * (op + 1);
+    };
+
+    ssw p(true);
+    {
+        perf::TimeGuard tg("SixSines 6 operator at()", __FILE__, __LINE__, 20 * 1000000);
+        for (int b = 0; b < blocks; ++b)
+        {
+            advance();
+            for (int op = 0; op < nOps; ++op)
+                for (int i = 0; i < bs; ++i)
+                    out[op][i] = p.at(phases[op][i]);
+            sink += out[3][7];
+        }
+    }
+    {
+        perf::TimeGuard tg("SixSines 6 operator lookupBlocks", __FILE__, __LINE__, 20 * 1000000);
+        for (int b = 0; b < blocks; ++b)
+        {
+            advance();
+            p.lookupBlocks<bs>(ph, ssw::SIN, outs, nOps);
+            sink += out[3][7];
+        }
+    }
+    {
+        perf::TimeGuard tg("SixSines 6 operator lookupBlockLinear", __FILE__, __LINE__,
+                           20 * 1000000);
+        for (int b = 0; b < blocks; ++b)
+        {
+            advance();
+            for (int op = 0; op < nOps; ++op)
+                p.lookupBlockLinear<bs>(phases[op], out[op]);
+            sink += out[3][7];
+        }
+    }
+
+    // per sample pitch and gain for 64 voices, 64 samples a block for 20 seconds at 48k
+    {
+        namespace tabl = sst::basic_blocks::tables;
+        static constexpr size_t pbs{64};
+        static constexpr int voices{64}, pblocks{48000 * 20 / (int)pbs};
+        float notes alignas(16)[pbs], res alignas(16)[pbs];
+        for (auto i = 0U; i < pbs; ++i)
+            notes[i] = 60.f + 0.013f * i;
+
+        tabl::EqualTuningProvider equal;
+        tabl::TwoToTheXProvider twox;
+        tabl::DbToLinearProvider dbt;
+        {
+            perf::TimeGuard tg("note_to_pitch scalar", __FILE__, __LINE__, 20 * 1000000);
+            for (int b = 0; b < pblocks; ++b)
+                for (int v = 0; v < voices; ++v)
+                {
+                    for (auto i = 0U; i < pbs; ++i)
+                        res[i] = equal.note_to_pitch(notes[i] + v);
+                    sink += res[v];
+                }
+        }
+        {
+            perf::TimeGuard tg("note_to_pitch block", __FILE__, __LINE__, 20 * 1000000);
+            float vn alignas(16)[pbs];
+            for (int b = 0; b < pblocks; ++b)
+                for (int v = 0; v < voices; ++v)
+                {
+                    for (auto i = 0U; i < pbs; ++i)
+                        vn[i] = notes[i] + v;
+                    equal.note_to_pitch<pbs>(vn, res);
+                    sink += res[v];
+                }
+        }
+        {
+            perf::TimeGuard tg("twoToThe scalar", __FILE__, __LINE__, 20 * 1000000);
+            for (int b = 0; b < pblocks; ++b)
+                for (int v = 0; v < voices; ++v)
+                {
+                    for (auto i = 0U; i < pbs; ++i)
+                        res[i] = twox.twoToThe((notes[i] + v) * (1.f / 12.f) - 5.f);
+                    sink += res[v];
+                }
+        }
+        {
+            perf::TimeGuard tg("twoToThe block", __FILE__, __LINE__, 20 * 1000000);
+            float vn alignas(16)[pbs];
+            for (int b = 0; b < pblocks; ++b)
+                for (int v = 0; v < voices; ++v)
+                {
+                    for (auto i = 0U; i < pbs; ++i)
+                        vn[i] = (notes[i] + v) * (1.f / 12.f) - 5.f;
+                    twox.twoToThe<pbs>(vn, res);
+                    sink += res[v];
+                }
+        }
+        {
+            perf::TimeGuard tg("dbToLinear scalar", __FILE__, __LINE__, 20 * 1000000);
+            for (int b = 0; b < pblocks; ++b)
+                for (int v = 0; v < voices; ++v)
+                {
+                    for (auto i = 0U; i < pbs; ++i)
+                        res[i] = dbt.dbToLinear(notes[i] - v - 60.f);
+                    sink += res[v];
+                }
+        }
+        {
+            perf::TimeGuard tg("dbToLinear block", __FILE__, __LINE__, 20 * 1000000);
+            float vn alignas(16)[pbs];
+            for (int b = 0; b < pblocks; ++b)
+                for (int v = 0; v < voices; ++v)
+                {
+                    for (auto i = 0U; i < pbs; ++i)
+                        vn[i] = notes[i] - v - 60.f;
+                    dbt.dbToLinear<pbs>(vn, res);
+                    sink += res[v];
+                }
+        }
+    }
+    std::cout << "Sink " << sink << std::endl;
+}
@@ -58,6 +58,21 @@ TEST_CASE("Sums", "[simd]")
     REQUIRE(sst::basic_blocks::mechanics::sum_ps_to_float(val) == Approx(1.0).margin(0.00001));
 }
 
+TEST_CASE("Four Sums At Once", "[simd]")
+{
+    namespace mech = sst::basic_blocks::mechanics;
+    auto a = SIMD_MM(setr_ps)(0.1, 0.2, 0.3, 0.4);
+    auto b = SIMD_MM(setr_ps)(1, 2, 3, 4);
+    auto c = SIMD_MM(setr_ps)(-1, 0.5, 0.25, 0.125);
+    auto d = SIMD_MM(setr_ps)(100, 0, 0, 7);
+    float res alignas(16)[4];
+    SIMD_MM(store_ps)(res, mech::hsum4_ps(a, b, c, d));
+    REQUIRE(res[0] == Approx(mech::hsum_ps(a)).margin(0.00001));
+    REQUIRE(res[1] == Approx(mech::hsum_ps(b)).margin(0.00001));
+    REQUIRE(res[2] == Approx(mech::hsum_ps(c)).margin(0.00001));
+    REQUIRE(res[3] == Approx(mech::hsum_ps(d)).margin(0.00001));
+}
+
 TEST_CASE("simd_float_extract", "[simd]")
 {
     float vals alignas(16)[4] = {1.25f, -2.5f, 3.75f, -4.0f};
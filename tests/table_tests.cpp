@@ -32,6 +32,11 @@
 #include "sst/basic-blocks/tables/TwoToTheXProvider.h"
 #include "sst/basic-blocks/tables/ExpTimeProvider.h"
 #include "sst/basic-blocks/tables/TemposyncSupport.h"
+#include "sst/basic-blocks/tables/SixSinesWaveProvider.h"
+
+#include <cmath>
+#include <thread>
+#include <vector>
 
 namespace tabl = sst::basic_blocks::tables;
 
@@ -72,6 +77,112 @@ TEST_CASE("Two to the X Provider", "[tables]")
     }
 }
 
+TEST_CASE("Constexpr Tables", "[tables]")
+{
+    static_assert(tabl::TwoToTheXProvider::table_two_to_the[0] == 1.f);
+    static_assert(tabl::TwoToTheXProvider::table_two_to_the[1000] == 2.f);
+    static_assert(tabl::TwoToTheXProvider::baseValue[15] == 1.f);
+    static_assert(tabl::detail::db_to_linear::table_dB[384] == 1.f);
+    static_assert(tabl::detail::equal_tuning::table_pitch[256 + 12] == 2.f);
+
+    SECTION("Tables Match Runtime Pow")
+    {
+        for (auto i = 0U; i < tabl::TwoToTheXProvider::nInterp; ++i)
+        {
+            INFO("Two to the X at " << i);
+            REQUIRE(tabl::TwoToTheXProvider::table_two_to_the[i] == (float)pow(2.0, i / 1000.0));
+        }
+        for (auto i = 0U; i < tabl::DbToLinearProvider::nPoints; ++i)
+        {
+            INFO("DB at " << i);
+            auto r = powf(10.f, 0.05f * ((float)i - 384.f));
+            REQUIRE(tabl::detail::db_to_linear::table_dB[i] == Approx(r).epsilon(1e-6));
+        }
+        for (auto i = 0U; i < tabl::detail::equal_tuning::tuning_table_size; ++i)
+        {
+            INFO("Pitch at " << i);
+            auto r = powf(2.f, ((float)i - 256.f) * (1.f / 12.f));
+            REQUIRE(tabl::detail::equal_tuning::table_pitch[i] == Approx(r).epsilon(1e-6));
+            REQUIRE(tabl::detail::equal_tuning::table_pitch_inv[i] ==
+                    Approx(1.f / r).epsilon(1e-6));
+        }
+    }
+
+    SECTION("Providers Work Without Init")
+    {
+        tabl::TwoToTheXProvider twox;
+        tabl::DbToLinearProvider dbt;
+        tabl::EqualTuningProvider equal;
+
+        REQUIRE(twox.twoToThe(3.5f) == Approx(pow(2.0, 3.5)).margin(1e-5));
+        REQUIRE(dbt.dbToLinear(-6.f) == Approx(pow(10, -6 / 20.0)).margin(1e-5));
+        REQUIRE(equal.note_to_pitch(12) == 2.0);
+    }
+}
+
+TEST_CASE("SIMD Table Providers", "[tables]")
+{
+    static constexpr size_t bs{64};
+    float in alignas(16)[bs], out alignas(16)[bs];
+
+    auto check = [&](auto &&scalar) {
+        for (auto i = 0U; i < bs; ++i)
+        {
+            INFO("At " << in[i]);
+            REQUIRE(out[i] == Approx(scalar(in[i])).epsilon(1e-6));
+        }
+    };
+
+    SECTION("Two to the X")
+    {
+        tabl::TwoToTheXProvider twox;
+        for (auto [lo, hi] : {std::pair{-10.f, 10.f}, {-14.99f, 16.9f}, {-0.01f, 0.01f}})
+        {
+            for (auto i = 0U; i < bs; ++i)
+                in[i] = lo + (hi - lo) * i / (bs - 1);
+            twox.twoToThe<bs>(in, out);
+            check([&](float x) { return twox.twoToThe(x); });
+        }
+
+        float r alignas(16)[4];
+        SIMD_MM(store_ps)(r, twox.twoToThe(SIMD_MM(set_ps)(3.f, -1.5f, 0.f, 1.f / 3.f)));
+        REQUIRE(r[0] == Approx(pow(2.0, 1.0 / 3.0)).margin(1e-5));
+        REQUIRE(r[1] == 1.f);
+        REQUIRE(r[2] == Approx(pow(2.0, -1.5)).margin(1e-5));
+        REQUIRE(r[3] == 8.f);
+    }
+
+    SECTION("Note to Pitch")
+    {
+        tabl::EqualTuningProvider equal;
+        for (auto [lo, hi] : {std::pair{0.f, 127.f}, {-200.f, 200.f}, {59.9f, 60.1f}})
+        {
+            for (auto i = 0U; i < bs; ++i)
+                in[i] = lo + (hi - lo) * i / (bs - 1);
+            equal.note_to_pitch<bs>(in, out);
+            check([&](float x) { return equal.note_to_pitch(x); });
+        }
+
+        for (auto i = 0U; i < bs; ++i)
+            in[i] = i * 12.f - 300.f;
+        equal.note_to_pitch<bs>(in, out);
+        for (auto i = 0U; i < bs; ++i)
+            REQUIRE(out[i] == equal.note_to_pitch(in[i]));
+    }
+
+    SECTION("DB to Linear")
+    {
+        tabl::DbToLinearProvider dbt;
+        for (auto [lo, hi] : {std::pair{-192.f, 10.f}, {-383.f, 127.f}, {-0.5f, 0.5f}})
+        {
+            for (auto i = 0U; i < bs; ++i)
+                in[i] = lo + (hi - lo) * i / (bs - 1);
+            dbt.dbToLinear<bs>(in, out);
+            check([&](float x) { return dbt.dbToLinear(x); });
+        }
+    }
+}
+
 TEST_CASE("ExpTimeProvider TwentyFiveSecondExpTable", "[tables]")
 {
     tabl::TwentyFiveSecondExpTable expTime;
@@ -347,3 +458,101 @@ TEST_CASE("Temposync ZeroOne", "[tables]")
         }
     }
 }
+
+TEST_CASE("SixSines Wave Provider", "[tables]")
+{
+    using ssw = tabl::SixSinesWaveProvider;
+
+    SECTION("Sine At Both Resolutions")
+    {
+        ssw full, half(false, true);
+        for (uint32_t ph = 0; ph < (1 << 26); ph += 7919)
+        {
+            auto x = 2.0 * M_PI * ph / (1 << 26);
+            INFO("Phase " << ph);
+            REQUIRE(full.at(ph) == Approx(std::sin(x)).margin(1e-3));
+            REQUIRE(half.at(ph) == Approx(std::sin(x)).margin(2e-3));
+        }
+    }
+
+    SECTION("Waveforms Are Built Lazily")
+    {
+        ssw sineOnly;
+        REQUIRE(ssw::isWaveFormBuilt(ssw::SIN));
+        sineOnly.setWaveForm(ssw::TUKEY_WINDOW);
+        REQUIRE(sineOnly.simdQuad == ssw::waveTable(ssw::SIN, false));
+        REQUIRE(!ssw::isWaveFormBuilt(ssw::TUKEY_WINDOW));
+
+        ssw all(true);
+        all.setWaveForm(ssw::TRIANGLE);
+        REQUIRE(ssw::isWaveFormBuilt(ssw::TRIANGLE));
+        REQUIRE(!ssw::isWaveFormBuilt(ssw::TRIANGLE, true));
+        REQUIRE(all.at(1 << 23) == Approx(0.5).margin(1e-3));
+    }
+
+    SECTION("Block Lookups")
+    {
+        static constexpr int bs{32};
+        uint32_t phases[3][bs];
+        for (int op = 0; op < 3; ++op)
+            for (int i = 0; i < bs; ++i)
+                phases[op][i] = (uint32_t)(i * 2097152.7 * (op + 1) + op * 11111);
+
+        for (auto half : {false, true})
+        {
+            ssw p(true, half), other(true, half);
+            for (auto wf : {ssw::SIN, ssw::SAWISH, ssw::TX3, ssw::TUKEY_WINDOW})
+            {
+                p.setWaveForm(wf);
+                float blk[bs], lin[bs], viaWf[bs];
+                p.lookupBlock<bs>(phases[0], blk);
+                p.lookupBlockLinear<bs>(phases[0], lin);
+                other.lookupBlock<bs>(phases[0], wf, viaWf);
+                for (int i = 0; i < bs; ++i)
+                {
+                    INFO("half " << half << " wf " << wf << " sample " << i);
+                    REQUIRE(blk[i] == p.at(phases[0][i]));
+                    REQUIRE(viaWf[i] == blk[i]);
+                    REQUIRE(lin[i] == Approx(blk[i]).margin(wf == ssw::SIN ? 2e-5 : 2e-3));
+                }
+            }
+
+            float res[3][bs];
+            const uint32_t *ph[3]{phases[0], phases[1], phases[2]};
+            float *outs[3]{res[0], res[1], res[2]};
+            p.setWaveForm(ssw::SIN);
+            p.lookupBlocks<bs>(ph, ssw::SIN, outs, 3);
+            for (int op = 0; op < 3; ++op)
+                for (int i = 0; i < bs; ++i)
+                    REQUIRE(res[op][i] == p.at(phases[op][i]));
+        }
+    }
+
+    SECTION("Concurrent Builds Agree")
+    {
+        static constexpr int nThreads{6};
+        // as void pointers since the SIMD type's alignment attributes don't survive a template
+        std::vector<std::vector<const void *>> res(nThreads);
+        std::vector<std::thread> ts;
+        for (int t = 0; t < nThreads; ++t)
+        {
+            ts.emplace_back([t, &res]() {
+                ssw p(true, t % 2);
+                for (int i = 0; i < ssw::NUM_WAVEFORMS; ++i)
+                {
+                    p.setWaveForm((ssw::WaveForm)((i + 5 * t) % ssw::NUM_WAVEFORMS));
+                    res[t].push_back(p.simdQuad);
+                }
+            });
+        }
+        for (auto &t : ts)
+            t.join();
+
+        for (int t = 0; t < nThreads; ++t)
+            for (int i = 0; i < ssw::NUM_WAVEFORMS; ++i)
+            {
+                auto wf = (ssw::WaveForm)((i + 5 * t) % ssw::NUM_WAVEFORMS);
+                REQUIRE(res[t][i] == (const void *)ssw::waveTable(wf, t % 2));
+            }
+    }
+}
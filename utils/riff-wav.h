@@ -0,0 +1,397 @@
+/*
+* sst-basic-blocks - an open source library of core audio utilities
+ * built by Surge Synth Team.
+ *
+ * Provides a collection of tools useful on the audio thread for blocks,
+ * modulation, etc... or useful for adapting code to multiple environments.
+ *
+ * Copyright 2023, various authors, as described in the GitHub
+ * transaction log. Parts of this code are derived from similar
+ * functions original in Surge or ShortCircuit.
+ *
+ * sst-basic-blocks is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html.
+ *
+ * A very small number of explicitly chosen header files can also be
+ * used in an MIT/BSD context. Please see the README.md file in this
+ * repo or the comments in the individual files. Only headers with an
+ * explicit mention that they are dual licensed may be copied and reused
+ * outside the GPL3 terms.
+ *
+ * All source in sst-basic-blocks available at
+ * https://github.com/surge-synthesizer/sst-basic-blocks
+ */
+
+#ifndef SST_BASIC_BLOCKS_UTILS_RIFF_WAV_H
+#define SST_BASIC_BLOCKS_UTILS_RIFF_WAV_H
+
+/*
+ * Minimal float WAV IO for the command line utilities. RIFFWavWriter streams a float wav
+ * to disk and MappedFloatWav maps one in, so neither needs the whole file in memory.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#if defined(_WIN32)
+#include <vector>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+struct RIFFWavWriter
+{
+    static constexpr size_t fnameLen{8192};
+    char fname[fnameLen];
+    FILE *outf{nullptr};
+    size_t elementsWritten{0};
+    size_t fileSizeLocation{0};
+    size_t dataSizeLocation{0};
+    size_t dataLen{0};
+
+    uint16_t nChannels{2};
+
+    std::string errMsg{};
+
+    RIFFWavWriter() {}
+
+    RIFFWavWriter(const char *f, uint16_t chan) : nChannels(chan)
+    {
+        strncpy(fname, f, fnameLen);
+        fname[fnameLen - 1] = '\0';
+    }
+    ~RIFFWavWriter()
+    {
+        if (!closeFile())
+        {
+            // Unhandleable error here. Throwing is bad. Reporting is useless.
+        }
+    }
+
+    void writeRIFFHeader()
+    {
+        pushc4('R', 'I', 'F', 'F');
+        fileSizeLocation = elementsWritten;
+        pushi32(0);
+        pushc4('W', 'A', 'V', 'E');
+    }
+
+    void writeFMTChunk(int32_t samplerate)
+    {
+        pushc4('f', 'm', 't', ' ');
+        pushi32(16);
+        pushi16(3);         // IEEE float
+        pushi16(nChannels); // channels
+        pushi32(samplerate);
+        pushi32(samplerate * nChannels * 4); // channels * bytes * samplerate
+        pushi16(nChannels * 4);              // align on pair of 4 byte samples
+        pushi16(8 * 4);                      // bits per sample
+    }
+
+    void writeINSTChunk(char keyroot, char keylow, char keyhigh, char vellow, char velhigh)
+    {
+        pushc4('i', 'n', 's', 't');
+        pushi32(8);
+        pushi8(keyroot);
+        pushi8(0);
+        pushi8(127);
+        pushi8(keylow);
+        pushi8(keyhigh);
+        pushi8(vellow);
+        pushi8(velhigh);
+        pushi8(0);
+    }
+
+    void startDataChunk()
+    {
+        pushc4('d', 'a', 't', 'a');
+        dataSizeLocation = elementsWritten;
+        pushi32(0);
+    }
+
+    void pushSamples(float d[2])
+    {
+        if (outf)
+        {
+            elementsWritten += fwrite(d, 1, nChannels * sizeof(float), outf);
+            dataLen += nChannels * sizeof(float);
+        }
+    }
+
+    void pushInterleavedBlock(float *d, size_t nSamples)
+    {
+        if (outf)
+        {
+            elementsWritten += fwrite(d, 1, nSamples * sizeof(float), outf);
+            dataLen += nSamples * sizeof(float);
+        }
+    }
+
+    void pushc4(char a, char b, char c, char d)
+    {
+        char f[4]{a, b, c, d};
+        pushc4(f);
+    }
+    void pushc4(char f[4])
+    {
+        if (outf)
+            elementsWritten += fwrite(f, sizeof(char), 4, outf);
+    }
+
+    void pushi32(int32_t i)
+    {
+        if (outf)
+            elementsWritten += std::fwrite(&i, sizeof(char), sizeof(uint32_t), outf);
+    }
+
+    void pushi16(int16_t i)
+    {
+        if (outf)
+            elementsWritten += fwrite(&i, sizeof(char), sizeof(uint16_t), outf);
+    }
+
+    void pushi8(char i)
+    {
+        if (outf)
+            elementsWritten += std::fwrite(&i, 1, 1, outf);
+    }
+    [[nodiscard]] bool openFile()
+    {
+        elementsWritten = 0;
+        dataLen = 0;
+        dataSizeLocation = 0;
+        fileSizeLocation = 0;
+
+        outf = fopen(fname, "wb");
+        if (!outf)
+        {
+            errMsg = "Unable to open '" + std::string(fname) + "' for writing";
+            return false;
+        }
+        return true;
+    }
+
+    bool isOpen() { return outf != nullptr; }
+    [[nodiscard]] bool closeFile()
+    {
+        if (outf)
+        {
+            int res;
+            res = std::fseek(outf, fileSizeLocation, SEEK_SET);
+            if (res)
+            {
+                std::cout << "SEEK ZERO ERROR" << std::endl;
+                return false;
+            }
+            int32_t chunklen = elementsWritten - 8; // minus riff and size
+            fwrite(&chunklen, sizeof(uint32_t), 1, outf);
+
+            res = std::fseek(outf, dataSizeLocation, SEEK_SET);
+            if (res)
+            {
+                return false;
+                std::cout << "SEEK ONE ERROR" << std::endl;
+            }
+            fwrite(&dataLen, sizeof(uint32_t), 1, outf);
+            std::fclose(outf);
+            outf = nullptr;
+        }
+        return true;
+    }
+
+    [[nodiscard]] size_t getSampleCount() const { return dataLen / (nChannels * sizeof(float)); }
+};
+
+/*
+ * A 32 bit float wav, memory mapped read only. Frames are interleaved in data and are
+ * paged in as you read them, so large files stream from disk. On windows we fall back to
+ * reading the file into memory.
+ */
+struct MappedFloatWav
+{
+    uint16_t nChannels{0};
+    uint32_t sampleRate{0};
+    size_t nFrames{0};
+    const unsigned char *data{nullptr};
+
+    std::string errMsg{};
+
+    MappedFloatWav() = default;
+    MappedFloatWav(const MappedFloatWav &) = delete;
+    MappedFloatWav &operator=(const MappedFloatWav &) = delete;
+    ~MappedFloatWav() { close(); }
+
+    [[nodiscard]] bool open(const char *fname)
+    {
+        close();
+#if defined(_WIN32)
+        auto f = fopen(fname, "rb");
+        if (!f)
+        {
+            errMsg = "Unable to open '" + std::string(fname) + "' for reading";
+            return false;
+        }
+        std::fseek(f, 0, SEEK_END);
+        mapLen = std::ftell(f);
+        std::fseek(f, 0, SEEK_SET);
+        contents.resize(mapLen);
+        auto rd = fread(contents.data(), 1, mapLen, f);
+        fclose(f);
+        if (rd != mapLen)
+        {
+            errMsg = "Unable to read '" + std::string(fname) + "'";
+            return false;
+        }
+        map = contents.data();
+#else
+        fd = ::open(fname, O_RDONLY);
+        if (fd < 0)
+        {
+            errMsg = "Unable to open '" + std::string(fname) + "' for reading";
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0)
+        {
+            errMsg = "Unable to stat '" + std::string(fname) + "'";
+            close();
+            return false;
+        }
+        mapLen = st.st_size;
+        auto m = mmap(nullptr, mapLen, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (m == MAP_FAILED)
+        {
+            errMsg = "Unable to map '" + std::string(fname) + "'";
+            close();
+            return false;
+        }
+        map = (const unsigned char *)m;
+        madvise(m, mapLen, MADV_SEQUENTIAL);
+#endif
+        if (!parse())
+        {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close()
+    {
+#if defined(_WIN32)
+        contents.clear();
+#else
+        if (map)
+            munmap((void *)map, mapLen);
+        if (fd >= 0)
+            ::close(fd);
+        fd = -1;
+#endif
+        map = nullptr;
+        data = nullptr;
+        mapLen = 0;
+    }
+
+    // Deinterleave frames [start, start + n) into out[c], n clamped to the file
+    size_t read(size_t start, size_t n, float *const *out) const
+    {
+        if (start >= nFrames)
+            return 0;
+        n = std::min(n, nFrames - start);
+        const auto *src = data + start * nChannels * sizeof(float);
+        for (size_t i = 0; i < n; ++i)
+        {
+            for (int c = 0; c < nChannels; ++c)
+            {
+                memcpy(&out[c][i], src, sizeof(float));
+                src += sizeof(float);
+            }
+        }
+        return n;
+    }
+
+  private:
+    const unsigned char *map{nullptr};
+    size_t mapLen{0};
+#if defined(_WIN32)
+    std::vector<unsigned char> contents;
+#else
+    int fd{-1};
+#endif
+
+    uint32_t u32(size_t at) const
+    {
+        uint32_t r;
+        memcpy(&r, map + at, sizeof(r));
+        return r;
+    }
+    uint16_t u16(size_t at) const
+    {
+        uint16_t r;
+        memcpy(&r, map + at, sizeof(r));
+        return r;
+    }
+
+    bool parse()
+    {
+        if (mapLen < 12 || memcmp(map, "RIFF", 4) != 0 || memcmp(map + 8, "WAVE", 4) != 0)
+        {
+            errMsg = "Not a RIFF WAVE file";
+            return false;
+        }
+
+        bool haveFmt{false};
+        size_t pos = 12;
+        while (pos + 8 <= mapLen)
+        {
+            auto len = (size_t)u32(pos + 4);
+            auto body = pos + 8;
+            if (memcmp(map + pos, "fmt ", 4) == 0 && len >= 16 && body + len <= mapLen)
+            {
+                auto fmt = u16(body);
+                if (fmt == 0xFFFE && len >= 26)
+                    fmt = u16(body + 24); // extensible; the subformat guid starts with the tag
+                nChannels = u16(body + 2);
+                sampleRate = u32(body + 4);
+                auto bits = u16(body + 14);
+                if (fmt != 3 || bits != 32 || nChannels == 0)
+                {
+                    errMsg = "Only 32 bit float wav files are supported";
+                    return false;
+                }
+                if (sampleRate == 0)
+                {
+                    errMsg = "fmt chunk has a zero sample rate";
+                    return false;
+                }
+                haveFmt = true;
+            }
+            else if (memcmp(map + pos, "data", 4) == 0)
+            {
+                if (!haveFmt)
+                {
+                    errMsg = "data chunk before fmt chunk";
+                    return false;
+                }
+                len = std::min(len, mapLen - body);
+                data = map + body;
+                nFrames = len / (nChannels * sizeof(float));
+                return true;
+            }
+            pos = body + len + (len & 1);
+        }
+        errMsg = "No data chunk";
+        return false;
+    }
+};
+
+#endif
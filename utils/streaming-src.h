@@ -0,0 +1,347 @@
+/*
+ * sst-basic-blocks - an open source library of core audio utilities
+ * built by Surge Synth Team.
+ *
+ * Provides a collection of tools useful on the audio thread for blocks,
+ * modulation, etc... or useful for adapting code to multiple environments.
+ *
+ * Copyright 2023, various authors, as described in the GitHub
+ * transaction log. Parts of this code are derived from similar
+ * functions original in Surge or ShortCircuit.
+ *
+ * sst-basic-blocks is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html.
+ *
+ * A very small number of explicitly chosen header files can also be
+ * used in an MIT/BSD context. Please see the README.md file in this
+ * repo or the comments in the individual files. Only headers with an
+ * explicit mention that they are dual licensed may be copied and reused
+ * outside the GPL3 terms.
+ *
+ * All source in sst-basic-blocks available at
+ * https://github.com/surge-synthesizer/sst-basic-blocks
+ */
+
+#ifndef SST_BASIC_BLOCKS_UTILS_STREAMING_SRC_H
+#define SST_BASIC_BLOCKS_UTILS_STREAMING_SRC_H
+
+/*
+ * Offline sample rate conversion of whole float wav files. The input is memory mapped and
+ * streamed through the library resamplers a chunk at a time and the output is written as
+ * it goes, so memory use does not grow with the file. Exact 2x and 4x conversions use the
+ * polyphase resamplers. Other upsampling ratios use LanczosResampler; other downsampling
+ * ratios use a Lanczos kernel stretched to the output rate, so content above the output
+ * Nyquist is filtered out rather than aliased.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "sst/basic-blocks/dsp/LanczosResampler.h"
+#include "riff-wav.h"
+
+namespace sst::basic_blocks::utils
+{
+struct StreamingSRCOptions
+{
+    uint32_t outputRate{48000};
+    size_t chunkFrames{1024};
+    bool forceGeneric{false};
+};
+
+struct StreamingSRCResult
+{
+    bool ok{false};
+    std::string errMsg{};
+    std::string method{};
+    size_t inputFrames{0}, outputFrames{0};
+    double seconds{0};
+
+    double inputSamplesPerSecond() const
+    {
+        return seconds > 0 ? inputFrames / seconds : 0;
+    }
+    double outputSamplesPerSecond() const
+    {
+        return seconds > 0 ? outputFrames / seconds : 0;
+    }
+};
+
+namespace detail
+{
+static constexpr int srcBlockSize{64};
+
+/*
+ * Pull stereo blocks from the mapped file (mono is duplicated and written back as mono)
+ * and hand finished output frames to the writer, so each strategy only deals with
+ * filling L and R.
+ */
+struct StreamIO
+{
+    const MappedFloatWav &in;
+    RIFFWavWriter &out;
+    size_t outputFramesWanted{0};
+    size_t outputFramesWritten{0};
+    std::vector<float> interleaved;
+
+    StreamIO(const MappedFloatWav &i, RIFFWavWriter &o, size_t want)
+        : in(i), out(o), outputFramesWanted(want)
+    {
+    }
+
+    // reads n frames from start, zero filling past the end of the file
+    void read(size_t start, size_t n, float *L, float *R) const
+    {
+        float *chans[2]{L, R};
+        auto got = in.read(start, n, chans);
+        if (in.nChannels == 1)
+            memcpy(R, L, got * sizeof(float));
+        for (auto i = got; i < n; ++i)
+        {
+            L[i] = 0.f;
+            R[i] = 0.f;
+        }
+    }
+
+    bool done() const { return outputFramesWritten >= outputFramesWanted; }
+
+    // writes up to n frames from L and R, skipping the first skip of them
+    void write(const float *L, const float *R, size_t n, size_t skip = 0)
+    {
+        n = std::min(n - std::min(skip, n), outputFramesWanted - outputFramesWritten);
+        interleaved.resize(n * in.nChannels);
+        for (size_t i = 0; i < n; ++i)
+        {
+            interleaved[i * in.nChannels] = L[i + skip];
+            if (in.nChannels == 2)
+                interleaved[i * 2 + 1] = R[i + skip];
+        }
+        out.pushInterleavedBlock(interleaved.data(), interleaved.size());
+        outputFramesWritten += n;
+    }
+};
+
+inline void convertGeneric(StreamIO &io, double inRate, double outRate, size_t chunkFrames)
+{
+    using resampler_t = sst::basic_blocks::dsp::LanczosResampler<srcBlockSize>;
+    // stay well within the resampler ring buffer between pulls
+    chunkFrames = std::min(chunkFrames, resampler_t::BUFFER_SZ / 2);
+
+    auto rs = std::make_unique<resampler_t>(inRate, outRate);
+    // reads at xBack land on input wp - 1 - xBack, so start a sample on to line up with input 0
+    rs->phaseO = 1.0;
+    std::vector<float> inL(chunkFrames), inR(chunkFrames);
+    auto outCap = (size_t)(chunkFrames * outRate / inRate) + 8;
+    std::vector<float> outL(outCap), outR(outCap);
+
+    size_t pos{0};
+    while (!io.done())
+    {
+        // output n is input position n * inRate / outRate; past the end we just feed zeros
+        io.read(pos, chunkFrames, inL.data(), inR.data());
+        for (size_t i = 0; i < chunkFrames; ++i)
+            rs->push(inL[i], inR[i]);
+        pos += chunkFrames;
+
+        size_t got;
+        while ((got = rs->populateNext(outL.data(), outR.data(), outCap)) > 0)
+            io.write(outL.data(), outR.data(), got);
+        rs->renormalizePhases();
+    }
+}
+
+/*
+ * LanczosResampler's kernel has a fixed width in input samples, so it only band limits at the
+ * input Nyquist and lets everything between the output and input Nyquist alias when
+ * downsampling. Here the kernel is stretched by inRate / outRate instead, which moves its
+ * cutoff to the output Nyquist. This is direct convolution over the mapped input, which is
+ * fine for an offline converter.
+ */
+inline void convertGenericDown(StreamIO &io, double inRate, double outRate, size_t chunkFrames)
+{
+    using tables_t = sst::basic_blocks::dsp::LanczosTables<4>;
+    const double step = inRate / outRate;
+    const double scale = outRate / inRate;
+    const double radius = tables_t::A * step;
+    const auto reach = (int64_t)std::ceil(radius) + 1;
+
+    std::vector<float> inL, inR, outL(chunkFrames), outR(chunkFrames), w;
+
+    size_t n0{0};
+    while (!io.done())
+    {
+        // the input span this chunk of output reads from, zero padded before the file start
+        auto first = (int64_t)std::floor(n0 * step) - reach;
+        auto last = (int64_t)std::ceil((n0 + chunkFrames - 1) * step) + reach;
+        auto lead = (size_t)std::max(-first, (int64_t)0);
+        auto nIn = (size_t)(last - first + 1);
+        inL.assign(nIn, 0.f);
+        inR.assign(nIn, 0.f);
+        io.read((size_t)(first + (int64_t)lead), nIn - lead, inL.data() + lead,
+                inR.data() + lead);
+
+        for (size_t i = 0; i < chunkFrames; ++i)
+        {
+            auto t = (n0 + i) * step;
+            auto k0 = (int64_t)std::ceil(t - radius), k1 = (int64_t)std::floor(t + radius);
+            double sL{0}, sR{0};
+            for (auto k = k0; k <= k1; ++k)
+            {
+                auto kw = tables_t::kernel((t - k) * scale);
+                sL += kw * inL[k - first];
+                sR += kw * inR[k - first];
+            }
+            outL[i] = (float)(sL * scale);
+            outR[i] = (float)(sR * scale);
+        }
+        io.write(outL.data(), outR.data(), chunkFrames);
+        n0 += chunkFrames;
+    }
+}
+
+template <int factor> inline void convertUp(StreamIO &io, size_t chunkFrames)
+{
+    using up_t = sst::basic_blocks::dsp::LanczosPolyphaseUpsampler<factor, srcBlockSize>;
+    auto up = std::make_unique<up_t>();
+    // the upsampler output lags the input by A input samples
+    size_t skip = up_t::A * factor;
+
+    chunkFrames = std::max(chunkFrames / srcBlockSize, (size_t)1) * srcBlockSize;
+    std::vector<float> inL(chunkFrames), inR(chunkFrames);
+    float outL[srcBlockSize * factor], outR[srcBlockSize * factor];
+
+    size_t pos{0};
+    while (!io.done())
+    {
+        io.read(pos, chunkFrames, inL.data(), inR.data());
+        pos += chunkFrames;
+        for (size_t b = 0; b < chunkFrames && !io.done(); b += srcBlockSize)
+        {
+            up->process(inL.data() + b, inR.data() + b, outL, outR);
+            auto s = std::min(skip, (size_t)(srcBlockSize * factor));
+            io.write(outL, outR, srcBlockSize * factor, s);
+            skip -= s;
+        }
+    }
+}
+
+template <int factor> inline void convertDown(StreamIO &io, size_t chunkFrames)
+{
+    using down_t = sst::basic_blocks::dsp::LanczosPolyphaseDownsampler<factor, srcBlockSize>;
+    auto down = std::make_unique<down_t>();
+    // the downsampler output lags by A - 1 output samples
+    size_t skip = down_t::A - 1;
+
+    static constexpr size_t inBlock = srcBlockSize * factor;
+    chunkFrames = std::max(chunkFrames / inBlock, (size_t)1) * inBlock;
+    std::vector<float> inL(chunkFrames), inR(chunkFrames);
+    float outL[srcBlockSize], outR[srcBlockSize];
+
+    size_t pos{0};
+    while (!io.done())
+    {
+        io.read(pos, chunkFrames, inL.data(), inR.data());
+        pos += chunkFrames;
+        for (size_t b = 0; b < chunkFrames && !io.done(); b += inBlock)
+        {
+            down->process(inL.data() + b, inR.data() + b, outL, outR);
+            auto s = std::min(skip, (size_t)srcBlockSize);
+            io.write(outL, outR, srcBlockSize, s);
+            skip -= s;
+        }
+    }
+}
+} // namespace detail
+
+/*
+ * Convert the float wav at inPath to opt.outputRate and write it to outPath. The output
+ * is aligned with the input (resampler latency is removed) and has the same duration.
+ * Mono and stereo files are supported.
+ */
+inline StreamingSRCResult convertFloatWav(const char *inPath, const char *outPath,
+                                          const StreamingSRCOptions &opt = {})
+{
+    StreamingSRCResult res;
+
+    MappedFloatWav in;
+    if (!in.open(inPath))
+    {
+        res.errMsg = in.errMsg;
+        return res;
+    }
+    if (in.nChannels > 2)
+    {
+        res.errMsg = "Only mono and stereo files are supported";
+        return res;
+    }
+    if (opt.outputRate == 0 || opt.chunkFrames == 0)
+    {
+        res.errMsg = "Output rate and chunk size must be positive";
+        return res;
+    }
+
+    RIFFWavWriter writer(outPath, in.nChannels);
+    if (!writer.openFile())
+    {
+        res.errMsg = writer.errMsg;
+        return res;
+    }
+    writer.writeRIFFHeader();
+    writer.writeFMTChunk(opt.outputRate);
+    writer.startDataChunk();
+
+    res.inputFrames = in.nFrames;
+    auto want = (size_t)((double)in.nFrames * opt.outputRate / in.sampleRate);
+    detail::StreamIO io(in, writer, want);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto inR = in.sampleRate, outR = opt.outputRate;
+    if (!opt.forceGeneric && outR == 2 * inR)
+    {
+        res.method = "polyphase 2x up";
+        detail::convertUp<2>(io, opt.chunkFrames);
+    }
+    else if (!opt.forceGeneric && outR == 4 * inR)
+    {
+        res.method = "polyphase 4x up";
+        detail::convertUp<4>(io, opt.chunkFrames);
+    }
+    else if (!opt.forceGeneric && inR == 2 * outR)
+    {
+        res.method = "polyphase 2x down";
+        detail::convertDown<2>(io, opt.chunkFrames);
+    }
+    else if (!opt.forceGeneric && inR == 4 * outR)
+    {
+        res.method = "polyphase 4x down";
+        detail::convertDown<4>(io, opt.chunkFrames);
+    }
+    else if (outR < inR)
+    {
+        res.method = "lanczos band limited down";
+        detail::convertGenericDown(io, inR, outR, opt.chunkFrames);
+    }
+    else
+    {
+        res.method = "lanczos";
+        detail::convertGeneric(io, inR, outR, opt.chunkFrames);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    res.outputFrames = io.outputFramesWritten;
+    res.seconds = std::chrono::duration<double>(end - start).count();
+    if (!writer.closeFile())
+    {
+        res.errMsg = "Unable to finalize '" + std::string(outPath) + "'";
+        return res;
+    }
+    res.ok = true;
+    return res;
+}
+} // namespace sst::basic_blocks::utils
+
+#endif
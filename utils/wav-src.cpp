@@ -0,0 +1,80 @@
+/*
+* sst-basic-blocks - an open source library of core audio utilities
+ * built by Surge Synth Team.
+ *
+ * Provides a collection of tools useful on the audio thread for blocks,
+ * modulation, etc... or useful for adapting code to multiple environments.
+ *
+ * Copyright 2023, various authors, as described in the GitHub
+ * transaction log. Parts of this code are derived from similar
+ * functions original in Surge or ShortCircuit.
+ *
+ * sst-basic-blocks is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html.
+ *
+ * A very small number of explicitly chosen header files can also be
+ * used in an MIT/BSD context. Please see the README.md file in this
+ * repo or the comments in the individual files. Only headers with an
+ * explicit mention that they are dual licensed may be copied and reused
+ * outside the GPL3 terms.
+ *
+ * All source in sst-basic-blocks available at
+ * https://github.com/surge-synthesizer/sst-basic-blocks
+ */
+
+/*
+ * wav-src in.wav out.wav rate [--chunk frames] [--generic]
+ *
+ * Converts a mono or stereo float wav to a new sample rate, streaming it from disk, and
+ * reports the throughput.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "streaming-src.h"
+
+int usage(const char *exe)
+{
+    std::cerr << "Usage: " << exe << " in.wav out.wav rate [--chunk frames] [--generic]\n"
+              << "  Converts a 32 bit float wav to the given sample rate.\n"
+              << "  --chunk    frames read from the input at a time (default 1024)\n"
+              << "  --generic  use the Lanczos resampler even for 2x and 4x ratios"
+              << std::endl;
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 4)
+        return usage(argv[0]);
+
+    sst::basic_blocks::utils::StreamingSRCOptions opt;
+    opt.outputRate = (uint32_t)std::strtoul(argv[3], nullptr, 10);
+    for (int i = 4; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--generic") == 0)
+            opt.forceGeneric = true;
+        else if (strcmp(argv[i], "--chunk") == 0 && i + 1 < argc)
+            opt.chunkFrames = (size_t)std::strtoul(argv[++i], nullptr, 10);
+        else
+            return usage(argv[0]);
+    }
+
+    auto res = sst::basic_blocks::utils::convertFloatWav(argv[1], argv[2], opt);
+    if (!res.ok)
+    {
+        std::cerr << "wav-src: " << res.errMsg << std::endl;
+        return 2;
+    }
+
+    std::cout << argv[1] << " -> " << argv[2] << " (" << res.method << ")\n"
+              << "  " << res.inputFrames << " frames in, " << res.outputFrames
+              << " frames out in " << res.seconds << "s\n"
+              << "  " << res.inputSamplesPerSecond() << " input samples/sec, "
+              << res.outputSamplesPerSecond() << " output samples/sec" << std::endl;
+    return 0;
+}